@@ -90,6 +90,7 @@ typedef struct LilvNodeImpl        LilvNode;         /**< Typed Value. */
 typedef struct LilvWorldImpl       LilvWorld;        /**< Lilv World. */
 typedef struct LilvInstanceImpl    LilvInstance;     /**< Plugin instance. */
 typedef struct LilvStateImpl       LilvState;        /**< Plugin state. */
+typedef struct LilvMatchesImpl     LilvMatches;      /**< Query results. */
 
 typedef void LilvIter;           /**< Collection iterator */
 typedef void LilvPluginClasses;  /**< set<PluginClass>. */
@@ -336,8 +337,8 @@ lilv_node_as_bool(const LilvNode* value);
    <li>LilvUIs (function prefix "lilv_uis_")</li>
    </ul>
 
-   Each collection type supports a similar basic API (except LilvPlugins which
-   is internal and thus lacks a free function):
+   Each collection type supports a similar basic API (except that
+   lilv_plugins_free() is only for results of lilv_world_find_plugins()):
    <ul>
    <li>void PREFIX_free (coll)</li>
    <li>unsigned PREFIX_size (coll)</li>
@@ -356,6 +357,17 @@ lilv_node_as_bool(const LilvNode* value);
       // ...
    }
    @endcode
+
+   An iterator refers to a position in the collection, so it remains usable
+   while the collection grows or shrinks, but elements inserted or removed
+   before that position during iteration may cause later elements to be
+   skipped or visited twice.  The collections returned by
+   lilv_world_get_all_plugins() and lilv_world_get_plugin_classes() are
+   modified by loading or unloading bundles or resources,
+   lilv_world_poll_changes(), and (with LILV_OPTION_LAZY_SPECIFICATIONS)
+   queries that load a specification defining new plugin classes.  To iterate
+   over them while other threads may be querying the world, call
+   lilv_world_freeze() first.
 */
 #define LILV_FOREACH(colltype, iter, collection) \
 	for (LilvIter* iter = lilv_ ## colltype ## _begin(collection); \
@@ -477,8 +489,66 @@ lilv_nodes_contains(const LilvNodes* nodes, const LilvNode* value);
 LILV_API LilvNodes*
 lilv_nodes_merge(const LilvNodes* a, const LilvNodes* b);
 
+/* Matches */
+
+/**
+   Free a stream of query results.
+
+   Streams are returned by lilv_world_find_matches(), lilv_plugin_get_matches(),
+   and lilv_port_get_matches().  Unlike the collections above, a stream reads
+   the world data directly, so it does not copy any nodes.  Other threads can
+   not load data into the world until the stream is freed, but the thread
+   that made it may, for example by calling a function that loads plugin data
+   when first needed.  The stream then continues from its current result,
+   but may or may not include results that were added meanwhile.  Bundles and
+   resources must not be unloaded while a stream exists, and a stream must be
+   freed by the thread that made it.
+*/
+LILV_API void
+lilv_matches_free(LilvMatches* matches);
+
+/**
+   Return true if there are no more results in `matches`.
+*/
+LILV_API bool
+lilv_matches_is_end(const LilvMatches* matches);
+
+/**
+   Return the current result of `matches`, or NULL at the end.
+
+   The returned node is a view into the world data, which is only valid until
+   the next call to lilv_matches_next() or lilv_matches_free().  It must not
+   be freed, but may be copied with lilv_node_duplicate().
+*/
+LILV_API const LilvNode*
+lilv_matches_get(const LilvMatches* matches);
+
+/**
+   Advance `matches` to the next result.
+*/
+LILV_API void
+lilv_matches_next(LilvMatches* matches);
+
+/**
+   Return the number of results remaining in `matches`, and move to the end.
+
+   This does not decode the results, so it is cheaper than stepping through
+   them with lilv_matches_next().
+*/
+LILV_API unsigned
+lilv_matches_count(LilvMatches* matches);
+
 /* Plugins */
 
+/**
+   Free a collection returned by lilv_world_find_plugins().
+
+   This does not free the plugins themselves, which are owned by the world.
+   Collections owned by the world must not be freed.
+*/
+LILV_API void
+lilv_plugins_free(LilvPlugins* collection);
+
 LILV_API unsigned
 lilv_plugins_size(const LilvPlugins* collection);
 
@@ -511,6 +581,14 @@ lilv_plugins_get_by_uri(const LilvPlugins* plugins,
    LV2 data (plugins, UIs, and extensions).
    Normal hosts which just need to load plugins by URI should simply use
    lilv_world_load_all() to discover/load the system's LV2 resources.
+
+   Where pthreads are available, a world may be queried from several threads
+   at once, including queries that load plugin data on demand.  Each plugin
+   is only loaded once, and loading excludes other queries only while data is
+   being added to the model.  Loading or unloading bundles and resources must
+   not happen while other threads are using the affected plugins or iterating
+   over collections owned by the world, and the state functions must not be
+   called concurrently.  To avoid loading entirely, see lilv_world_freeze().
    @{
 */
 
@@ -530,6 +608,17 @@ lilv_world_new(void);
 */
 #define LILV_OPTION_FILTER_LANG "http://drobilla.net/ns/lilv#filter-lang"
 
+/**
+   Set the language used for language filtering.
+
+   The value is a language tag string like "de-AT", and may also be in the
+   format of the LANG environment variable like "de_AT.UTF-8".  An empty
+   string selects only untranslated values.  If this is not set, the language
+   is taken from LANG when the world is created.  Changes to LANG after that
+   are ignored, unless this option is set to NULL, which reads LANG again.
+*/
+#define LILV_OPTION_LANG "http://drobilla.net/ns/lilv#lang"
+
 /**
    Enable/disable dynamic manifest support.
    Dynamic manifest data will only be loaded if this option is true.
@@ -543,13 +632,86 @@ lilv_world_new(void);
 */
 #define LILV_OPTION_LV2_PATH "http://drobilla.net/ns/lilv#lv2-path"
 
+/**
+   Set the path of a discovery cache file used by lilv_world_load_all().
+
+   If this is set, then the manifest data of every bundle found is saved to
+   this file after loading.  Later calls to lilv_world_load_all(), typically
+   in another process, only read the manifests of bundles which have been
+   added or modified since, and take everything else from the cache.  A
+   bundle is considered modified if the modification time, size, or inode of
+   its directory or manifest file has changed.
+
+   The cache is disabled by default.
+*/
+#define LILV_OPTION_DISCOVERY_CACHE "http://drobilla.net/ns/lilv#discovery-cache"
+
+/**
+   Set the number of threads used to read manifests in lilv_world_load_all().
+
+   If this is greater than one, then bundle manifests are read in parallel by
+   this many threads.  The results are then added to the world in the same
+   order as a sequential scan, so the same plugins are found either way.  This
+   option has no effect on systems without thread support.
+
+   The default is zero, which reads everything in the calling thread.
+*/
+#define LILV_OPTION_LOAD_THREADS "http://drobilla.net/ns/lilv#load-threads"
+
+/**
+   Enable/disable lazy loading of specifications.
+
+   If this is true, then lilv_world_load_all() only reads the manifests of
+   specification bundles, and the data of a specification is loaded the first
+   time a subject or predicate in its namespace is queried with
+   lilv_world_find_nodes(), lilv_world_get(), or lilv_world_ask().  Plugin
+   classes are loaded when they are first accessed.  All specifications can
+   be loaded explicitly with lilv_world_load_specifications().
+
+   Since data is only loaded for a subject or predicate in the namespace of a
+   specification, queries with only an object bound, like finding every
+   subclass of a class, do not find statements in specifications that have
+   not been loaded yet.  Plugin classes from a specification are added when
+   it is loaded, so more classes may appear after any query.
+
+   If this is false, then all specification data and plugin classes are
+   loaded by lilv_world_load_all().  Lazy loading is disabled by default.
+*/
+#define LILV_OPTION_LAZY_SPECIFICATIONS \
+	"http://drobilla.net/ns/lilv#lazy-specifications"
+
+/**
+   Set the number of query results remembered by the world.
+
+   If this is greater than zero, then the results of lilv_world_find_nodes(),
+   lilv_world_get(), and lilv_world_ask() are remembered, so repeating a query
+   does not search the model again.  The cache has a fixed number of entries,
+   and each result replaces any other that maps to the same entry.  Every
+   result is forgotten when statements are added to or removed from the
+   world, for example when a bundle is loaded or unloaded or plugin data is
+   loaded when first queried, or when the language changes.  The hit and miss
+   counts are available from lilv_world_get_stats().
+
+   Only the search is saved: a remembered result is still copied for every
+   call, and must be freed by the caller as usual.
+
+   The default is zero, which disables the cache.
+*/
+#define LILV_OPTION_QUERY_CACHE_SIZE \
+	"http://drobilla.net/ns/lilv#query-cache-size"
+
 /**
    Set an option option for `world`.
 
    Currently recognized options:
    @ref LILV_OPTION_FILTER_LANG
+   @ref LILV_OPTION_LANG
    @ref LILV_OPTION_DYN_MANIFEST
    @ref LILV_OPTION_LV2_PATH
+   @ref LILV_OPTION_DISCOVERY_CACHE
+   @ref LILV_OPTION_LOAD_THREADS
+   @ref LILV_OPTION_LAZY_SPECIFICATIONS
+   @ref LILV_OPTION_QUERY_CACHE_SIZE
 */
 LILV_API void
 lilv_world_set_option(LilvWorld*      world,
@@ -627,6 +789,36 @@ lilv_world_load_plugin_classes(LilvWorld* world);
 LILV_API int
 lilv_world_unload_bundle(LilvWorld* world, const LilvNode* bundle_uri);
 
+/**
+   Start watching the directories in LV2_PATH for changes.
+
+   After this is called, lilv_world_poll_changes() can be used to pick up
+   bundles that have been installed, updated, or removed since, without
+   reloading everything.  This should be called after lilv_world_load_all(),
+   and only watches directories in LV2_PATH that exist at the time.
+
+   Watching is currently only supported on Linux.
+
+   @return Zero on success, or non-zero if watching is unsupported or failed.
+*/
+LILV_API int
+lilv_world_watch(LilvWorld* world);
+
+/**
+   Apply any changes to bundles in LV2_PATH since the last poll.
+
+   This does not block.  All pending changes are collected first, then every
+   affected bundle is unloaded, loaded, or reloaded once.  As with
+   lilv_world_unload_bundle(), plugins that disappear are no longer in the
+   list returned by lilv_world_get_all_plugins(), but remain valid until the
+   world is freed.  Plugins in bundles that changed are reloaded on demand.
+
+   @return The number of bundles that were changed, or -1 if
+   lilv_world_watch() has not been successfully called.
+*/
+LILV_API int
+lilv_world_poll_changes(LilvWorld* world);
+
 /**
    Load all the data associated with the given `resource`.
    @param world The world.
@@ -652,6 +844,32 @@ LILV_API int
 lilv_world_unload_resource(LilvWorld*      world,
                            const LilvNode* resource);
 
+/**
+   Load everything that would otherwise be loaded on demand, and make the
+   world immutable.
+
+   This loads all specifications, plugin classes, plugin data and ports, and
+   resources related to plugins such as presets.  After this, the world is
+   thread-safe: it can be queried, and plugins instantiated, from several
+   threads at once without any locking by the caller.  Threads that use the
+   world must be started, or otherwise synchronized with, after this returns.
+
+   Queries are not entirely lock-free.  Nodes made from the model are
+   borrowed rather than copied, and literals are decoded here once, so making
+   them only locks the allocation of the node itself.  Searches of the model
+   are still serialized by an internal mutex, so many threads that only run
+   queries will not scale linearly.  This requires pthread support.
+
+   Functions that would modify the world, such as lilv_world_load_bundle(),
+   lilv_world_load_resource(), and lilv_world_set_option(), fail with an
+   error once the world is frozen.  The state functions are not covered, and
+   must still be called from one thread at a time.  A frozen world can not be
+   thawed, but it can be freed with lilv_world_free() as usual, once no other
+   threads are using it.
+*/
+LILV_API void
+lilv_world_freeze(LilvWorld* world);
+
 /**
    Get the parent of all other plugin classes, lv2:Plugin.
 */
@@ -679,6 +897,97 @@ lilv_world_get_plugin_classes(const LilvWorld* world);
 LILV_API const LilvPlugins*
 lilv_world_get_all_plugins(const LilvWorld* world);
 
+/**
+   Find plugins by class, required features, and audio ports.
+
+   The first time this is called, the data of every plugin is loaded, and
+   indexes of plugins by class, required feature, and number of audio ports
+   are built.  Later searches only intersect these indexes, until plugins are
+   added or removed by loading or unloading bundles.
+
+   @param world The world.
+   @param plugin_class Class that plugins must be, or be a subclass of, or
+   NULL for any class.
+   @param supported_features Features supported by the host, or NULL.  If
+   this is not NULL, plugins that require any other feature are excluded.
+   @param n_audio_inputs Number of audio input ports, or -1 for any number.
+   @param n_audio_outputs Number of audio output ports, or -1 for any number.
+   @return A new collection of plugins owned by `world`, which must be freed
+   by the caller with lilv_plugins_free().
+*/
+LILV_API LilvPlugins*
+lilv_world_find_plugins(LilvWorld*             world,
+                        const LilvPluginClass* plugin_class,
+                        const LilvNodes*       supported_features,
+                        int32_t                n_audio_inputs,
+                        int32_t                n_audio_outputs);
+
+/**
+   Search plugins by name, label, author, and project.
+
+   The search text is split into words, which are matched case-insensitively
+   against the words of each plugin's doap:name, rdfs:label, author name, and
+   project name, in the language selected for language filtering.  A
+   plugin matches if every search word is a prefix of one of its words, or
+   for words of at least 3 characters, occurs anywhere within one.
+
+   Matches are ranked with exact words above prefixes above substrings, and
+   names above labels above project names above author names.  The first time
+   this is called, an index of these words is built, which is kept until
+   plugins are added or removed.
+
+   @param world The world.
+   @param text Search text, as UTF-8.
+   @param results Array to fill with the best matches, in order, or NULL.
+   @param max_results Size of `results`.
+   @return The total number of matching plugins, which may be larger than
+   `max_results`.
+*/
+LILV_API unsigned
+lilv_world_search_plugins(LilvWorld*         world,
+                          const char*        text,
+                          const LilvPlugin** results,
+                          unsigned           max_results);
+
+/**
+   Return a URID map for `world`.
+
+   This is a complete implementation of the LV2 URID map interface, which can
+   be given to plugins as it is.  Mapping a URI is a hash table lookup, and
+   unmapping a URID is an array index.  Both are thread-safe, and only mapping
+   a URI for the first time takes a lock.  URIs stay mapped until the world is
+   freed, and mapped strings are stored with the other URIs in the world.
+
+   The returned map is owned by `world` and must not be freed.
+*/
+LILV_API LV2_URID_Map*
+lilv_world_get_urid_map(LilvWorld* world);
+
+/**
+   Return a URID unmap for the map returned by lilv_world_get_urid_map().
+
+   The returned unmap is owned by `world` and must not be freed.
+*/
+LILV_API LV2_URID_Unmap*
+lilv_world_get_urid_unmap(LilvWorld* world);
+
+/**
+   Return an LV2_URID__map feature with the map from lilv_world_get_urid_map().
+
+   The returned feature is owned by `world` and must not be freed.
+*/
+LILV_API const LV2_Feature*
+lilv_world_get_urid_map_feature(LilvWorld* world);
+
+/**
+   Return an LV2_URID__unmap feature with the unmap from
+   lilv_world_get_urid_unmap().
+
+   The returned feature is owned by `world` and must not be freed.
+*/
+LILV_API const LV2_Feature*
+lilv_world_get_urid_unmap_feature(LilvWorld* world);
+
 /**
    Find nodes matching a triple pattern.
    Either `subject` or `object` may be NULL (i.e. a wildcard), but not both.
@@ -690,6 +999,23 @@ lilv_world_find_nodes(LilvWorld*      world,
                       const LilvNode* predicate,
                       const LilvNode* object);
 
+/**
+   Stream the nodes matching a triple pattern.
+
+   This is like lilv_world_find_nodes(), but returns the matches one at a time
+   without copying them, so stopping early or counting matches does not
+   allocate any nodes.  Unlike lilv_world_find_nodes(), matches are never
+   filtered by language.
+
+   @return A stream which must be freed with lilv_matches_free(), or NULL if
+   the pattern is invalid.
+*/
+LILV_API LilvMatches*
+lilv_world_find_matches(LilvWorld*      world,
+                        const LilvNode* subject,
+                        const LilvNode* predicate,
+                        const LilvNode* object);
+
 /**
    Find a single node that matches a pattern.
    Exactly one of `subject`, `predicate`, `object` must be NULL.
@@ -731,6 +1057,59 @@ lilv_world_ask(LilvWorld*      world,
 LILV_API LilvNode*
 lilv_world_get_symbol(LilvWorld* world, const LilvNode* subject);
 
+/**
+   Statistics about the work done by a world.
+
+   Counters accumulate from when the world is created, or from the last call
+   to lilv_world_reset_stats().  The model fields describe the model at the
+   time the statistics are read.  Times are in seconds, and are zero on
+   systems without a monotonic clock.
+*/
+typedef struct {
+	uint64_t n_bundles;        /**< Bundles scanned. */
+	uint64_t n_files;          /**< Data files parsed. */
+	uint64_t n_statements;     /**< Statements added by parsing files. */
+	double   parse_time;       /**< Time spent parsing files. */
+	uint64_t n_searches;       /**< Model searches done for queries. */
+	uint64_t n_plugin_loads;   /**< Plugins loaded when first queried. */
+	uint64_t n_lib_opens;      /**< Plugin libraries opened. */
+	double   lib_open_time;    /**< Time spent opening plugin libraries. */
+	uint64_t n_query_cache_hits;   /**< Queries answered by the cache. */
+	uint64_t n_query_cache_misses; /**< Queries not found in the cache. */
+	uint64_t model_statements; /**< Statements in the model. */
+	uint64_t model_nodes;      /**< Distinct nodes in the model. */
+	uint64_t model_size;       /**< Rough estimate of model memory in bytes. */
+} LilvWorldStats;
+
+/**
+   Get statistics about the work done by `world`.
+
+   This may be called while other threads are using the world.
+*/
+LILV_API void
+lilv_world_get_stats(const LilvWorld* world, LilvWorldStats* stats);
+
+/**
+   Reset all counters and times in the statistics of `world` to zero.
+
+   This includes the parse times of bundles.
+*/
+LILV_API void
+lilv_world_reset_stats(LilvWorld* world);
+
+/**
+   Return the time spent parsing the data files of a bundle.
+
+   This includes the manifest, and any data files in the bundle directory that
+   are loaded later, for example when a plugin is first queried.  Bundles that
+   were restored from the discovery cache are not parsed.
+
+   @return The parse time in seconds, or zero if the bundle is not known.
+*/
+LILV_API double
+lilv_world_get_bundle_parse_time(const LilvWorld* world,
+                                 const LilvNode*  bundle_uri);
+
 /**
    @}
    @name Plugin
@@ -812,6 +1191,17 @@ lilv_plugin_get_library_uri(const LilvPlugin* plugin);
 LILV_API LilvNode*
 lilv_plugin_get_name(const LilvPlugin* plugin);
 
+/**
+   Get the name of `plugin` without allocating.
+
+   This returns the same value as lilv_plugin_get_name(), but the node is
+   remembered by the world, so repeated calls are cheap.  The returned value
+   is owned by the world and must not be freed.  It is valid until a bundle
+   is loaded or unloaded, or the language used for filtering changes.
+*/
+LILV_API const LilvNode*
+lilv_plugin_borrow_name(const LilvPlugin* plugin);
+
 /**
    Get the class this plugin belongs to (e.g. Filters).
 */
@@ -834,6 +1224,16 @@ LILV_API LilvNodes*
 lilv_plugin_get_value(const LilvPlugin* plugin,
                       const LilvNode*   predicate);
 
+/**
+   Stream the values of a plugin property.
+
+   This is the streaming analog of lilv_plugin_get_value(), see
+   lilv_world_find_matches().
+*/
+LILV_API LilvMatches*
+lilv_plugin_get_matches(const LilvPlugin* plugin,
+                        const LilvNode*   predicate);
+
 /**
    Return whether a feature is supported by a plugin.
    This will return true if the feature is an optional or required feature
@@ -914,7 +1314,9 @@ lilv_plugin_get_num_ports(const LilvPlugin* plugin);
 
    This is a convenience method for the common case of getting the range of
    all float ports on a plugin, and may be significantly faster than
-   repeated calls to lilv_port_get_range().
+   repeated calls to lilv_port_get_range().  The values are copied from the
+   port table (see lilv_plugin_get_port_table()), so no nodes are allocated
+   once the table has been built.
 */
 LILV_API void
 lilv_plugin_get_port_ranges_float(const LilvPlugin* plugin,
@@ -922,6 +1324,75 @@ lilv_plugin_get_port_ranges_float(const LilvPlugin* plugin,
                                   float*            max_values,
                                   float*            def_values);
 
+/**
+   Direction of a port in a LilvPortDescriptor.
+*/
+typedef enum {
+	LILV_PORT_DIRECTION_UNKNOWN = 0, /**< Neither input nor output. */
+	LILV_PORT_DIRECTION_INPUT   = 1, /**< lv2:InputPort. */
+	LILV_PORT_DIRECTION_OUTPUT  = 2  /**< lv2:OutputPort. */
+} LilvPortDirection;
+
+/**
+   Port types, as flags in LilvPortDescriptor::types.
+*/
+typedef enum {
+	LILV_PORT_TYPE_AUDIO   = 1u << 0u, /**< lv2:AudioPort. */
+	LILV_PORT_TYPE_CONTROL = 1u << 1u, /**< lv2:ControlPort. */
+	LILV_PORT_TYPE_CV      = 1u << 2u, /**< lv2:CVPort. */
+	LILV_PORT_TYPE_ATOM    = 1u << 3u, /**< atom:AtomPort. */
+	LILV_PORT_TYPE_EVENT   = 1u << 4u  /**< ev:EventPort (deprecated). */
+} LilvPortType;
+
+/**
+   Well-known port properties, as flags in LilvPortDescriptor::properties.
+*/
+typedef enum {
+	LILV_PORT_PROPERTY_CONNECTION_OPTIONAL = 1u << 0u,  /**< lv2 */
+	LILV_PORT_PROPERTY_ENUMERATION         = 1u << 1u,  /**< lv2 */
+	LILV_PORT_PROPERTY_INTEGER             = 1u << 2u,  /**< lv2 */
+	LILV_PORT_PROPERTY_IS_SIDE_CHAIN       = 1u << 3u,  /**< lv2 */
+	LILV_PORT_PROPERTY_REPORTS_LATENCY     = 1u << 4u,  /**< lv2 */
+	LILV_PORT_PROPERTY_SAMPLE_RATE         = 1u << 5u,  /**< lv2 */
+	LILV_PORT_PROPERTY_TOGGLED             = 1u << 6u,  /**< lv2 */
+	LILV_PORT_PROPERTY_CAUSES_ARTIFACTS    = 1u << 7u,  /**< port-props */
+	LILV_PORT_PROPERTY_EXPENSIVE           = 1u << 8u,  /**< port-props */
+	LILV_PORT_PROPERTY_HAS_STRICT_BOUNDS   = 1u << 9u,  /**< port-props */
+	LILV_PORT_PROPERTY_LOGARITHMIC         = 1u << 10u, /**< port-props */
+	LILV_PORT_PROPERTY_NOT_AUTOMATIC       = 1u << 11u, /**< port-props */
+	LILV_PORT_PROPERTY_NOT_ON_GUI          = 1u << 12u, /**< port-props */
+	LILV_PORT_PROPERTY_TRIGGER             = 1u << 13u  /**< port-props */
+} LilvPortProperty;
+
+/**
+   A summary of a port, as an element of a plugin's port table.
+*/
+typedef struct {
+	uint32_t          index;      /**< Port index. */
+	const char*       symbol;     /**< Port symbol, owned by the plugin. */
+	LilvPortDirection direction;  /**< Port direction. */
+	uint32_t          types;      /**< Port types, as LilvPortType flags. */
+	uint32_t          properties; /**< LilvPortProperty flags. */
+	float             min;        /**< lv2:minimum, or NAN. */
+	float             max;        /**< lv2:maximum, or NAN. */
+	float             def;        /**< lv2:default, or NAN. */
+} LilvPortDescriptor;
+
+/**
+   Get a table that summarizes all the ports of `plugin`.
+
+   This returns an array of lilv_plugin_get_num_ports() descriptors, indexed
+   by port index.  The table is built the first time it is requested, after
+   which this is cheap, so hosts can use it to set up instances without
+   making many queries.  Range values are NAN if they are not given as
+   numbers.  Properties other than those in LilvPortProperty can be checked
+   with lilv_port_has_property().
+
+   @return A table owned by `plugin`, or NULL if the plugin has no ports.
+*/
+LILV_API const LilvPortDescriptor*
+lilv_plugin_get_port_table(const LilvPlugin* plugin);
+
 /**
    Get the number of ports on this plugin that are members of some class(es).
    Note that this is a varargs function so ports fitting any type 'profile'
@@ -1026,6 +1497,33 @@ lilv_plugin_get_author_email(const LilvPlugin* plugin);
 LILV_API LilvNode*
 lilv_plugin_get_author_homepage(const LilvPlugin* plugin);
 
+/**
+   Get the full name of the plugin's author without allocating.
+
+   Like lilv_plugin_get_author_name(), but the returned value is owned by the
+   world, and valid as described for lilv_plugin_borrow_name().
+*/
+LILV_API const LilvNode*
+lilv_plugin_borrow_author_name(const LilvPlugin* plugin);
+
+/**
+   Get the email address of the plugin's author without allocating.
+
+   Like lilv_plugin_get_author_email(), but the returned value is owned by
+   the world, and valid as described for lilv_plugin_borrow_name().
+*/
+LILV_API const LilvNode*
+lilv_plugin_borrow_author_email(const LilvPlugin* plugin);
+
+/**
+   Get the address of the plugin author's home page without allocating.
+
+   Like lilv_plugin_get_author_homepage(), but the returned value is owned by
+   the world, and valid as described for lilv_plugin_borrow_name().
+*/
+LILV_API const LilvNode*
+lilv_plugin_borrow_author_homepage(const LilvPlugin* plugin);
+
 /**
    Return true iff `plugin` has been replaced by another plugin.
 
@@ -1101,6 +1599,14 @@ lilv_port_get_value(const LilvPlugin* plugin,
                     const LilvPort*   port,
                     const LilvNode*   predicate);
 
+/**
+   Port analog of lilv_plugin_get_matches().
+*/
+LILV_API LilvMatches*
+lilv_port_get_matches(const LilvPlugin* plugin,
+                      const LilvPort*   port,
+                      const LilvNode*   predicate);
+
 /**
    Get a single property value of a port.
 
@@ -1167,6 +1673,16 @@ LILV_API LilvNode*
 lilv_port_get_name(const LilvPlugin* plugin,
                    const LilvPort*   port);
 
+/**
+   Get the name of a port without allocating.
+
+   Like lilv_port_get_name(), but the returned value is owned by the world,
+   and valid as described for lilv_plugin_borrow_name().
+*/
+LILV_API const LilvNode*
+lilv_port_borrow_name(const LilvPlugin* plugin,
+                      const LilvPort*   port);
+
 /**
    Get all the classes of a port.
    This can be used to determine if a port is an input, output, audio,
@@ -1609,6 +2125,14 @@ lilv_plugin_class_get_uri(const LilvPluginClass* plugin_class);
 LILV_API const LilvNode*
 lilv_plugin_class_get_label(const LilvPluginClass* plugin_class);
 
+/**
+   Get the superclass of this plugin class.
+   Returned value is owned by the world and must not be freed by caller.
+   Returned value may be NULL, if class has no parent that is a known class.
+*/
+LILV_API const LilvPluginClass*
+lilv_plugin_class_get_parent(const LilvPluginClass* plugin_class);
+
 /**
    Get the subclasses of this plugin class.
    Returned value must be freed by caller with lilv_plugin_classes_free().
@@ -1616,6 +2140,27 @@ lilv_plugin_class_get_label(const LilvPluginClass* plugin_class);
 LILV_API LilvPluginClasses*
 lilv_plugin_class_get_children(const LilvPluginClass* plugin_class);
 
+/**
+   Get the direct subclasses of this plugin class.
+
+   This is like lilv_plugin_class_get_children(), but does not allocate.
+   Returned value is owned by `plugin_class` and must not be freed by caller.
+   It remains valid until more plugin classes are loaded.
+*/
+LILV_API const LilvPluginClasses*
+lilv_plugin_class_get_subclasses(const LilvPluginClass* plugin_class);
+
+/**
+   Return true iff `plugin_class` is `ancestor` or a descendant of it.
+
+   For example, this can be used to check if the class of a plugin is any
+   kind of filter.  The time taken is proportional to the depth of
+   `plugin_class` in the class hierarchy.
+*/
+LILV_API bool
+lilv_plugin_class_is_a(const LilvPluginClass* plugin_class,
+                       const LilvPluginClass* ancestor);
+
 /**
    @}
    @name Plugin Instance
@@ -0,0 +1,579 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#define _POSIX_C_SOURCE 200809L  /* for st_mtim */
+#define _BSD_SOURCE     1        /* for st_mtimespec */
+#define _DEFAULT_SOURCE 1        /* for st_mtimespec */
+
+#if defined(__APPLE__)
+#    define _DARWIN_C_SOURCE 1  /* for st_mtimespec */
+#endif
+
+#include "filesystem.h"
+#include "lilv_internal.h"
+
+#include "sord/sord.h"
+#include "zix/common.h"
+#include "zix/tree.h"
+
+#include <sys/stat.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  The discovery cache is a small text file which records, for every bundle
+  found in LV2_PATH, the statements read from its manifest along with enough
+  information about the bundle directory and manifest file to detect changes.
+
+  The file starts with a header line, followed by a record for each bundle:
+
+      bundle <uri> <dir stamp> <manifest stamp> <n_triples>
+      <subject> <predicate> <object>
+      ...
+
+  Strings are written as "<length>:<bytes>" so that they may contain any
+  characters.  Nodes are a type character ('U' for URIs, 'B' for blank nodes,
+  or 'L' for literals) followed by a string, and for literals, a datatype URI
+  string and a language string which are empty if not present.
+*/
+
+#define LILV_CACHE_HEADER "lilv-discovery-cache 2"
+
+/** The state of a file at the time it was read. */
+typedef struct {
+	long long          mtime;     ///< Modification time in seconds
+	long long          mtime_ns;  ///< Nanoseconds of mtime, or zero
+	long long          ctime;     ///< Status change time in seconds
+	long long          size;
+	unsigned long long inode;
+} LilvFileStamp;
+
+typedef struct {
+	char*         uri;        ///< Bundle URI
+	LilvFileStamp dir;        ///< State of bundle directory
+	LilvFileStamp manifest;   ///< State of manifest.ttl
+	SordNode**    nodes;      ///< Manifest statements, 3 nodes per triple
+	size_t        n_triples;  ///< Number of triples in nodes
+	bool          complete;   ///< True if statements have been recorded
+} LilvCacheEntry;
+
+struct LilvCacheImpl {
+	LilvWorld* world;
+	char*      path;
+	ZixTree*   old_entries;  ///< Entries read from the cache file
+	ZixTree*   new_entries;  ///< Entries for bundles seen in this scan
+};
+
+static int
+lilv_cache_entry_cmp(const void* a, const void* b, void* user_data)
+{
+	return strcmp(((const LilvCacheEntry*)a)->uri,
+	              ((const LilvCacheEntry*)b)->uri);
+}
+
+static LilvCacheEntry*
+lilv_cache_entry_new(const char* uri)
+{
+	LilvCacheEntry* entry = (LilvCacheEntry*)calloc(1, sizeof(LilvCacheEntry));
+	entry->uri = lilv_strdup(uri);
+	return entry;
+}
+
+static void
+lilv_cache_entry_clear(LilvCache* cache, LilvCacheEntry* entry)
+{
+	for (size_t i = 0; i < entry->n_triples * 3; ++i) {
+		sord_node_free(cache->world->world, entry->nodes[i]);
+	}
+	free(entry->nodes);
+	entry->nodes     = NULL;
+	entry->n_triples = 0;
+	entry->complete  = false;
+}
+
+static void
+lilv_cache_entry_free(LilvCache* cache, LilvCacheEntry* entry)
+{
+	lilv_cache_entry_clear(cache, entry);
+	free(entry->uri);
+	free(entry);
+}
+
+static LilvCacheEntry*
+lilv_cache_find(ZixTree* entries, const char* uri)
+{
+	LilvCacheEntry key = {
+		(char*)uri, { 0, 0, 0, 0, 0 }, { 0, 0, 0, 0, 0 }, NULL, 0, 0 };
+	ZixTreeIter* iter = NULL;
+	if (!zix_tree_find(entries, &key, &iter)) {
+		return (LilvCacheEntry*)zix_tree_get(iter);
+	}
+	return NULL;
+}
+
+static bool
+lilv_file_stamp(const char* path, LilvFileStamp* stamp)
+{
+	struct stat st;
+	if (stat(path, &st)) {
+		return false;
+	}
+
+	/* Seconds alone miss a bundle rewritten in place within the same second,
+	   so use the sub-second part where available, and the status change time
+	   which any rewrite also updates. */
+	stamp->mtime = (long long)st.st_mtime;
+#if defined(HAVE_STAT_MTIM)
+	stamp->mtime_ns = (long long)st.st_mtim.tv_nsec;
+#elif defined(HAVE_STAT_MTIMESPEC)
+	stamp->mtime_ns = (long long)st.st_mtimespec.tv_nsec;
+#else
+	stamp->mtime_ns = 0;
+#endif
+	stamp->ctime = (long long)st.st_ctime;
+	stamp->size  = (long long)st.st_size;
+	stamp->inode = (unsigned long long)st.st_ino;
+	return true;
+}
+
+static bool
+lilv_file_stamp_equals(const LilvFileStamp* a, const LilvFileStamp* b)
+{
+	return a->mtime == b->mtime && a->mtime_ns == b->mtime_ns &&
+	       a->ctime == b->ctime && a->size == b->size && a->inode == b->inode;
+}
+
+/* Reading */
+
+static char*
+read_string(FILE* fd)
+{
+	unsigned long len = 0;
+	if (fscanf(fd, " %lu:", &len) != 1) {
+		return NULL;
+	}
+
+	char* const str = (char*)malloc(len + 1);
+	if (!str || fread(str, 1, len, fd) != len) {
+		free(str);
+		return NULL;
+	}
+
+	str[len] = '\0';
+	return str;
+}
+
+static SordNode*
+read_node(LilvCache* cache, FILE* fd)
+{
+	SordWorld* const world = cache->world->world;
+	char             type  = '\0';
+	if (fscanf(fd, " %c", &type) != 1) {
+		return NULL;
+	}
+
+	char* const str = read_string(fd);
+	if (!str) {
+		return NULL;
+	}
+
+	SordNode* node = NULL;
+	if (type == 'U') {
+		node = sord_new_uri(world, (const uint8_t*)str);
+	} else if (type == 'B') {
+		node = sord_new_blank(world, (const uint8_t*)str);
+	} else if (type == 'L') {
+		char* const datatype = read_string(fd);
+		char* const lang     = datatype ? read_string(fd) : NULL;
+		if (lang) {
+			SordNode* const datatype_node =
+			    *datatype ? sord_new_uri(world, (const uint8_t*)datatype)
+			              : NULL;
+
+			node = sord_new_literal(
+			    world, datatype_node, (const uint8_t*)str, *lang ? lang : NULL);
+
+			sord_node_free(world, datatype_node);
+		}
+		free(lang);
+		free(datatype);
+	}
+
+	free(str);
+	return node;
+}
+
+static LilvCacheEntry*
+read_entry(LilvCache* cache, FILE* fd)
+{
+	char keyword[8] = { '\0' };
+	if (fscanf(fd, " %7s", keyword) != 1 || strcmp(keyword, "bundle")) {
+		return NULL;
+	}
+
+	char* const uri = read_string(fd);
+	if (!uri) {
+		return NULL;
+	}
+
+	LilvCacheEntry* const entry     = lilv_cache_entry_new(uri);
+	unsigned long         n_triples = 0;
+	free(uri);
+
+	if (fscanf(fd,
+	           " %lld %lld %lld %lld %llu %lld %lld %lld %lld %llu %lu",
+	           &entry->dir.mtime,
+	           &entry->dir.mtime_ns,
+	           &entry->dir.ctime,
+	           &entry->dir.size,
+	           &entry->dir.inode,
+	           &entry->manifest.mtime,
+	           &entry->manifest.mtime_ns,
+	           &entry->manifest.ctime,
+	           &entry->manifest.size,
+	           &entry->manifest.inode,
+	           &n_triples) != 11) {
+		lilv_cache_entry_free(cache, entry);
+		return NULL;
+	}
+
+	entry->nodes = (SordNode**)calloc(n_triples * 3, sizeof(SordNode*));
+	if (n_triples && !entry->nodes) {
+		lilv_cache_entry_free(cache, entry);
+		return NULL;
+	}
+
+	for (; entry->n_triples < n_triples; ++entry->n_triples) {
+		SordNode** const triple = entry->nodes + entry->n_triples * 3;
+		for (unsigned i = 0; i < 3; ++i) {
+			if (!(triple[i] = read_node(cache, fd))) {
+				// Free the partial triple, then the complete ones
+				for (unsigned j = 0; j < i; ++j) {
+					sord_node_free(cache->world->world, triple[j]);
+				}
+				lilv_cache_entry_free(cache, entry);
+				return NULL;
+			}
+		}
+	}
+
+	entry->complete = true;
+	return entry;
+}
+
+static void
+lilv_cache_read(LilvCache* cache)
+{
+	FILE* const fd = fopen(cache->path, "rb");
+	if (!fd) {
+		return;  // No cache yet
+	}
+
+	char header[64] = { '\0' };
+	if (!fgets(header, sizeof(header), fd) ||
+	    strcmp(header, LILV_CACHE_HEADER "\n")) {
+		LILV_WARNF("Ignoring invalid discovery cache `%s'\n", cache->path);
+		fclose(fd);
+		return;
+	}
+
+	LilvCacheEntry* entry = NULL;
+	while ((entry = read_entry(cache, fd))) {
+		if (zix_tree_insert(cache->old_entries, entry, NULL)) {
+			lilv_cache_entry_free(cache, entry);
+		}
+	}
+
+	if (!feof(fd)) {
+		// Treat bundles after a corrupt record as changed
+		LILV_WARNF("Error reading discovery cache `%s'\n", cache->path);
+	}
+
+	fclose(fd);
+}
+
+/* Writing */
+
+static void
+write_string(FILE* fd, const char* str, size_t len)
+{
+	fprintf(fd, "%lu:", (unsigned long)len);
+	fwrite(str, 1, len, fd);
+}
+
+static void
+write_node(FILE* fd, const SordNode* node)
+{
+	size_t            len = 0;
+	const char* const str =
+	    (const char*)sord_node_get_string_counted(node, &len);
+
+	switch (sord_node_get_type(node)) {
+	case SORD_URI:
+		fputc('U', fd);
+		write_string(fd, str, len);
+		break;
+	case SORD_BLANK:
+		fputc('B', fd);
+		write_string(fd, str, len);
+		break;
+	case SORD_LITERAL: {
+		const SordNode* const datatype = sord_node_get_datatype(node);
+		const char* const     dt_str =
+		    datatype ? (const char*)sord_node_get_string(datatype) : "";
+		const char* const lang = sord_node_get_language(node);
+
+		fputc('L', fd);
+		write_string(fd, str, len);
+		fputc(' ', fd);
+		write_string(fd, dt_str, strlen(dt_str));
+		fputc(' ', fd);
+		write_string(fd, lang ? lang : "", lang ? strlen(lang) : 0);
+		break;
+	}
+	}
+}
+
+static int
+write_entry(FILE* fd, const LilvCacheEntry* entry)
+{
+	fputs("bundle ", fd);
+	write_string(fd, entry->uri, strlen(entry->uri));
+	fprintf(fd,
+	        " %lld %lld %lld %lld %llu %lld %lld %lld %lld %llu %lu\n",
+	        entry->dir.mtime,
+	        entry->dir.mtime_ns,
+	        entry->dir.ctime,
+	        entry->dir.size,
+	        entry->dir.inode,
+	        entry->manifest.mtime,
+	        entry->manifest.mtime_ns,
+	        entry->manifest.ctime,
+	        entry->manifest.size,
+	        entry->manifest.inode,
+	        (unsigned long)entry->n_triples);
+
+	for (size_t i = 0; i < entry->n_triples; ++i) {
+		SordNode* const* const triple = entry->nodes + i * 3;
+		write_node(fd, triple[0]);
+		fputc(' ', fd);
+		write_node(fd, triple[1]);
+		fputc(' ', fd);
+		write_node(fd, triple[2]);
+		fputc('\n', fd);
+	}
+
+	return ferror(fd);
+}
+
+/* Public internal API */
+
+LilvCache*
+lilv_cache_new(LilvWorld* world, const char* path)
+{
+	LilvCache* cache = (LilvCache*)calloc(1, sizeof(LilvCache));
+
+	cache->world       = world;
+	cache->path        = lilv_strdup(path);
+	cache->old_entries = zix_tree_new(false, lilv_cache_entry_cmp, NULL, NULL);
+	cache->new_entries = zix_tree_new(false, lilv_cache_entry_cmp, NULL, NULL);
+
+	lilv_cache_read(cache);
+	return cache;
+}
+
+static void
+lilv_cache_free_entries(LilvCache* cache, ZixTree* entries)
+{
+	for (ZixTreeIter* i = zix_tree_begin(entries); !zix_tree_iter_is_end(i);
+	     i              = zix_tree_iter_next(i)) {
+		lilv_cache_entry_free(cache, (LilvCacheEntry*)zix_tree_get(i));
+	}
+	zix_tree_free(entries);
+}
+
+void
+lilv_cache_free(LilvCache* cache)
+{
+	if (cache) {
+		lilv_cache_free_entries(cache, cache->new_entries);
+		lilv_cache_free_entries(cache, cache->old_entries);
+		free(cache->path);
+		free(cache);
+	}
+}
+
+bool
+lilv_cache_check_bundle(LilvCache*      cache,
+                        const char*     bundle_path,
+                        const SordNode* bundle)
+{
+	const char* const uri = (const char*)sord_node_get_string(bundle);
+	if (lilv_cache_find(cache->new_entries, uri)) {
+		return false;  // Already seen in this scan (duplicate path entry)
+	}
+
+	// Record the state of the bundle before it may be (re-)read
+	LilvFileStamp dir;
+	LilvFileStamp manifest;
+	char* const   manifest_path = lilv_path_join(bundle_path, "manifest.ttl");
+	const bool    found         = (lilv_file_stamp(bundle_path, &dir) &&
+                        lilv_file_stamp(manifest_path, &manifest));
+	free(manifest_path);
+	if (!found) {
+		return false;
+	}
+
+	LilvCacheEntry* const entry = lilv_cache_entry_new(uri);
+	entry->dir                  = dir;
+	entry->manifest             = manifest;
+	zix_tree_insert(cache->new_entries, entry, NULL);
+
+	LilvCacheEntry* const old = lilv_cache_find(cache->old_entries, uri);
+	if (!old || !old->complete || !lilv_file_stamp_equals(&old->dir, &dir) ||
+	    !lilv_file_stamp_equals(&old->manifest, &manifest)) {
+		return false;  // Bundle is new or has changed
+	}
+
+	// Take the statements from the old entry
+	entry->nodes     = old->nodes;
+	entry->n_triples = old->n_triples;
+	entry->complete  = true;
+	old->nodes       = NULL;
+	old->n_triples   = 0;
+	old->complete    = false;
+	return true;
+}
+
+void
+lilv_cache_restore_bundle(LilvCache* cache, const SordNode* bundle)
+{
+	LilvWorld* const      world = cache->world;
+	LilvCacheEntry* const entry =
+	    lilv_cache_find(cache->new_entries,
+	                    (const char*)sord_node_get_string(bundle));
+	if (!entry || !entry->complete) {
+		return;
+	}
+
+	// Prefix blank node labels like the reader would for a fresh parse
+	char* const prefix =
+	    lilv_strdup((const char*)lilv_world_blank_node_prefix(world));
+
+	for (size_t i = 0; i < entry->n_triples; ++i) {
+		SordQuad quad = { NULL, NULL, NULL, (SordNode*)bundle };
+		for (unsigned j = 0; j < 3; ++j) {
+			const SordNode* const node = entry->nodes[i * 3 + j];
+			if (sord_node_get_type(node) == SORD_BLANK) {
+				char* const label = lilv_strjoin(
+				    prefix, (const char*)sord_node_get_string(node), NULL);
+				quad[j] = sord_new_blank(world->world, (const uint8_t*)label);
+				free(label);
+			} else {
+				quad[j] = sord_node_copy(node);
+			}
+		}
+
+		sord_add(world->model, quad);
+		for (unsigned j = 0; j < 3; ++j) {
+			sord_node_free(world->world, (SordNode*)quad[j]);
+		}
+	}
+
+	free(prefix);
+}
+
+void
+lilv_cache_capture_bundle(LilvCache* cache, const SordNode* bundle)
+{
+	LilvCacheEntry* const entry =
+	    lilv_cache_find(cache->new_entries,
+	                    (const char*)sord_node_get_string(bundle));
+	if (!entry || entry->complete) {
+		return;
+	}
+
+	size_t    n_nodes = 0;
+	SordIter* i       = sord_search(cache->world->model, NULL, NULL, NULL, bundle);
+	for (; !sord_iter_end(i); sord_iter_next(i)) {
+		if (entry->n_triples * 3 == n_nodes) {
+			n_nodes      = n_nodes ? n_nodes * 2 : 48;
+			entry->nodes = (SordNode**)realloc(entry->nodes,
+			                                   n_nodes * sizeof(SordNode*));
+		}
+
+		SordQuad quad;
+		sord_iter_get(i, quad);
+		for (unsigned j = 0; j < 3; ++j) {
+			entry->nodes[entry->n_triples * 3 + j] = sord_node_copy(quad[j]);
+		}
+		++entry->n_triples;
+	}
+	sord_iter_free(i);
+
+	entry->complete = true;
+}
+
+int
+lilv_cache_write(const LilvCache* cache)
+{
+	char* const dir = lilv_path_parent(cache->path);
+	if (lilv_create_directories(dir)) {
+		LILV_ERRORF("Failed to create directory `%s'\n", dir);
+		free(dir);
+		return 1;
+	}
+	free(dir);
+
+	// Write to a temporary file first so readers never see a partial cache
+	char* const tmp_path = lilv_strjoin(cache->path, ".tmp", NULL);
+	FILE* const fd       = fopen(tmp_path, "wb");
+	if (!fd) {
+		LILV_ERRORF("Failed to open `%s' for writing\n", tmp_path);
+		free(tmp_path);
+		return 1;
+	}
+
+	int st = fputs(LILV_CACHE_HEADER "\n", fd) < 0;
+	for (ZixTreeIter* i = zix_tree_begin(cache->new_entries);
+	     !st && !zix_tree_iter_is_end(i);
+	     i = zix_tree_iter_next(i)) {
+		const LilvCacheEntry* const entry =
+		    (const LilvCacheEntry*)zix_tree_get(i);
+		if (entry->complete) {
+			st = write_entry(fd, entry);
+		}
+	}
+
+	st = fclose(fd) || st;
+#ifdef _WIN32
+	if (!st) {
+		remove(cache->path);
+	}
+#endif
+	if (st || rename(tmp_path, cache->path)) {
+		LILV_ERRORF("Failed to write discovery cache `%s'\n", cache->path);
+		remove(tmp_path);
+		st = 1;
+	}
+
+	free(tmp_path);
+	return st;
+}
@@ -19,16 +19,17 @@
 #include "lilv/lilv.h"
 #include "sord/sord.h"
 #include "zix/common.h"
-#include "zix/tree.h"
 
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 int
 lilv_ptr_cmp(const void* a, const void* b, void* user_data)
 {
-	return (intptr_t)a - (intptr_t)b;
+	return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
 }
 
 int
@@ -36,42 +37,172 @@ lilv_resource_node_cmp(const void* a, const void* b, void* user_data)
 {
 	const SordNode* an = ((const LilvNode*)a)->node;
 	const SordNode* bn = ((const LilvNode*)b)->node;
-	return (intptr_t)an - (intptr_t)bn;
+	return ((uintptr_t)an > (uintptr_t)bn) - ((uintptr_t)an < (uintptr_t)bn);
 }
 
 /* Generic collection functions */
 
-static inline LilvCollection*
+LilvCollection*
 lilv_collection_new(ZixComparator cmp, ZixDestroyFunc destructor)
 {
-	return zix_tree_new(false, cmp, NULL, destructor);
+	LilvCollection* collection =
+		(LilvCollection*)calloc(1, sizeof(LilvCollection));
+
+	collection->cmp     = cmp;
+	collection->destroy = destructor;
+	return collection;
 }
 
 void
 lilv_collection_free(LilvCollection* collection)
 {
 	if (collection) {
-		zix_tree_free((ZixTree*)collection);
+		if (collection->destroy) {
+			for (unsigned i = 0; i < collection->n_elems; ++i) {
+				collection->destroy(collection->elems[i]);
+			}
+		}
+
+		free(collection->elems);
+		free(collection);
 	}
 }
 
 unsigned
 lilv_collection_size(const LilvCollection* collection)
 {
-	return (collection ? zix_tree_size((const ZixTree*)collection) : 0);
+	return (collection ? collection->n_elems : 0);
+}
+
+/*
+  Iterators are element indices plus one, so a NULL iterator is never valid
+  and iterators are not invalidated when the element array is reallocated.
+*/
+
+static inline LilvIter*
+lilv_iter_from_index(const unsigned index)
+{
+	return (LilvIter*)(uintptr_t)(index + 1u);
+}
+
+static inline unsigned
+lilv_iter_index(const LilvIter* i)
+{
+	return (unsigned)((uintptr_t)i - 1u);
 }
 
 LilvIter*
 lilv_collection_begin(const LilvCollection* collection)
 {
-	return collection ? (LilvIter*)zix_tree_begin((ZixTree*)collection) : NULL;
+	return (collection && collection->n_elems) ? lilv_iter_from_index(0u)
+	                                           : NULL;
 }
 
 void*
 lilv_collection_get(const LilvCollection* collection,
                     const LilvIter*       i)
 {
-	return zix_tree_get((const ZixTreeIter*)i);
+	return lilv_collection_is_end(collection, i)
+		? NULL
+		: collection->elems[lilv_iter_index(i)];
+}
+
+LilvIter*
+lilv_collection_next(const LilvCollection* collection, LilvIter* i)
+{
+	return i ? lilv_iter_from_index(lilv_iter_index(i) + 1u) : NULL;
+}
+
+bool
+lilv_collection_is_end(const LilvCollection* collection, const LilvIter* i)
+{
+	return !collection || !i || lilv_iter_index(i) >= collection->n_elems;
+}
+
+/** Return the index of the first element not less than `key`. */
+static unsigned
+lilv_collection_bound(const LilvCollection* collection, const void* key)
+{
+	unsigned lo = 0;
+	unsigned hi = collection->n_elems;
+
+	// Elements are often added in order, so check the end first
+	if (hi && collection->cmp(collection->elems[hi - 1], key, NULL) < 0) {
+		return hi;
+	}
+
+	while (lo < hi) {
+		const unsigned mid = lo + (hi - lo) / 2;
+		if (collection->cmp(collection->elems[mid], key, NULL) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+ZixStatus
+lilv_collection_insert(LilvCollection* collection, void* elem)
+{
+	const unsigned i = lilv_collection_bound(collection, elem);
+	if (i < collection->n_elems &&
+	    !collection->cmp(collection->elems[i], elem, NULL)) {
+		return ZIX_STATUS_EXISTS;
+	}
+
+	if (collection->n_elems == collection->capacity) {
+		const unsigned capacity =
+			collection->capacity ? collection->capacity * 2 : 4;
+		void** const elems =
+			(void**)realloc(collection->elems, capacity * sizeof(void*));
+		if (!elems) {
+			return ZIX_STATUS_NO_MEM;
+		}
+
+		collection->elems    = elems;
+		collection->capacity = capacity;
+	}
+
+	memmove(collection->elems + i + 1,
+	        collection->elems + i,
+	        (collection->n_elems - i) * sizeof(void*));
+
+	collection->elems[i] = elem;
+	++collection->n_elems;
+	return ZIX_STATUS_SUCCESS;
+}
+
+LilvIter*
+lilv_collection_find(const LilvCollection* collection, const void* key)
+{
+	const unsigned i = lilv_collection_bound(collection, key);
+
+	return (i < collection->n_elems &&
+	        !collection->cmp(collection->elems[i], key, NULL))
+		? lilv_iter_from_index(i)
+		: NULL;
+}
+
+LilvIter*
+lilv_collection_lower_bound(const LilvCollection* collection, const void* key)
+{
+	return lilv_iter_from_index(lilv_collection_bound(collection, key));
+}
+
+void
+lilv_collection_remove(LilvCollection* collection, LilvIter* i)
+{
+	const unsigned index = lilv_iter_index(i);
+	void** const   elem  = collection->elems + index;
+
+	if (collection->destroy) {
+		collection->destroy(*elem);
+	}
+
+	memmove(elem, elem + 1, (collection->n_elems - index - 1) * sizeof(void*));
+	--collection->n_elems;
 }
 
 /* Constructors */
@@ -104,6 +235,106 @@ lilv_plugin_classes_new(void)
 	                           (ZixDestroyFunc)lilv_plugin_class_free);
 }
 
+/* URI indexes (hash tables of things with URIs, by interned node) */
+
+/** Return the first slot to probe for `node`, which is interned. */
+static uint32_t
+lilv_uri_index_slot(const LilvURIIndex* index, const SordNode* node)
+{
+	const uint32_t h = (uint32_t)((uintptr_t)node >> 4u);
+	return (h * 2654435761u) & index->mask;
+}
+
+static void
+lilv_uri_index_place(LilvURIIndex* index, struct LilvHeader* header)
+{
+	uint32_t s = lilv_uri_index_slot(index, header->uri->node);
+	while (index->slots[s]) {
+		s = (s + 1u) & index->mask;
+	}
+
+	index->slots[s] = header;
+}
+
+void
+lilv_uri_index_insert(LilvURIIndex* index, struct LilvHeader* header)
+{
+	// Grow to keep the table at most half full
+	if (!index->slots || (index->n_entries + 1u) * 2u > index->mask + 1u) {
+		struct LilvHeader** const old_slots = index->slots;
+		const uint32_t            old_size  = old_slots ? index->mask + 1u : 0u;
+		const uint32_t            new_size  = old_size ? old_size * 2u : 16u;
+
+		index->slots =
+			(struct LilvHeader**)calloc(new_size, sizeof(struct LilvHeader*));
+		index->mask = new_size - 1u;
+		for (uint32_t i = 0u; i < old_size; ++i) {
+			if (old_slots[i]) {
+				lilv_uri_index_place(index, old_slots[i]);
+			}
+		}
+
+		free(old_slots);
+	}
+
+	lilv_uri_index_place(index, header);
+	++index->n_entries;
+}
+
+void
+lilv_uri_index_remove(LilvURIIndex* index, const struct LilvHeader* header)
+{
+	if (!index->slots) {
+		return;
+	}
+
+	uint32_t s = lilv_uri_index_slot(index, header->uri->node);
+	while (index->slots[s] != header) {
+		if (!index->slots[s]) {
+			return;  // Not in index
+		}
+
+		s = (s + 1u) & index->mask;
+	}
+
+	// Shift later entries in the same probe sequence back to fill the hole
+	index->slots[s] = NULL;
+	for (uint32_t i = (s + 1u) & index->mask; index->slots[i];
+	     i = (i + 1u) & index->mask) {
+		struct LilvHeader* const moved = index->slots[i];
+		index->slots[i]                = NULL;
+		lilv_uri_index_place(index, moved);
+	}
+
+	--index->n_entries;
+}
+
+struct LilvHeader*
+lilv_uri_index_get(const LilvURIIndex* index, const SordNode* node)
+{
+	if (!index->slots) {
+		return NULL;
+	}
+
+	for (uint32_t s = lilv_uri_index_slot(index, node); index->slots[s];
+	     s = (s + 1u) & index->mask) {
+		if (index->slots[s]->uri->node == node) {
+			return index->slots[s];
+		}
+	}
+
+	return NULL;
+}
+
+void
+lilv_uri_index_free(LilvURIIndex* index)
+{
+	free(index->slots);
+	index->slots     = NULL;
+	index->n_entries = 0u;
+	index->mask      = 0u;
+}
+
 /* URI based accessors (for collections of things with URIs) */
 
 const LilvPluginClass*
@@ -111,13 +342,13 @@ lilv_plugin_classes_get_by_uri(const LilvPluginClasses* classes,
                                const LilvNode*          uri)
 {
 	return (LilvPluginClass*)lilv_collection_get_by_uri(
-		(const ZixTree*)classes, uri);
+		classes, uri);
 }
 
 const LilvUI*
 lilv_uis_get_by_uri(const LilvUIs* uis, const LilvNode* uri)
 {
-	return (LilvUI*)lilv_collection_get_by_uri((const ZixTree*)uis, uri);
+	return (LilvUI*)lilv_collection_get_by_uri(uis, uri);
 }
 
 /* Plugins */
@@ -132,7 +363,7 @@ const LilvPlugin*
 lilv_plugins_get_by_uri(const LilvPlugins* plugins, const LilvNode* uri)
 {
 	return (LilvPlugin*)lilv_collection_get_by_uri(
-		(const ZixTree*)plugins, uri);
+		plugins, uri);
 }
 
 /* Nodes */
@@ -155,14 +386,12 @@ lilv_nodes_merge(const LilvNodes* a, const LilvNodes* b)
 	LilvNodes* result = lilv_nodes_new();
 
 	LILV_FOREACH(nodes, i, a)
-		zix_tree_insert((ZixTree*)result,
-		                lilv_node_duplicate(lilv_nodes_get(a, i)),
-		                NULL);
+		lilv_collection_insert(result,
+		                       lilv_node_duplicate(lilv_nodes_get(a, i)));
 
 	LILV_FOREACH(nodes, i, b)
-		zix_tree_insert((ZixTree*)result,
-		                lilv_node_duplicate(lilv_nodes_get(b, i)),
-		                NULL);
+		lilv_collection_insert(result,
+		                       lilv_node_duplicate(lilv_nodes_get(b, i)));
 
 	return result;
 }
@@ -191,13 +420,13 @@ prefix##_get(const CT* collection, LilvIter* i) { \
 \
 LilvIter* \
 prefix##_next(const CT* collection, LilvIter* i) { \
-	return zix_tree_iter_next((ZixTreeIter*)i); \
+	return lilv_collection_next(collection, i); \
 } \
 \
 \
 bool \
 prefix##_is_end(const CT* collection, LilvIter* i) { \
-	return zix_tree_iter_is_end((ZixTreeIter*)i); \
+	return lilv_collection_is_end(collection, i); \
 }
 
 LILV_COLLECTION_IMPL(lilv_plugin_classes, LilvPluginClasses, LilvPluginClass)
@@ -211,6 +440,11 @@ lilv_plugin_classes_free(LilvPluginClasses* collection) {
 	lilv_collection_free(collection);
 }
 
+void
+lilv_plugins_free(LilvPlugins* collection) {
+	lilv_collection_free(collection);
+}
+
 void
 lilv_scale_points_free(LilvScalePoints* collection) {
 	lilv_collection_free(collection);
@@ -0,0 +1,343 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+#include "sord/sord.h"
+#include "zix/tree.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+  The plugin index maps plugin classes, required features, and audio port
+  layouts to the set of plugins with each.  It is built from the data of
+  every plugin the first time plugins are searched for, and dropped whenever
+  plugins are added or removed.
+*/
+
+/** Maximum number of audio inputs or outputs distinguished by the index. */
+#define LILV_INDEX_MAX_AUDIO_PORTS 0xFFFFu
+
+/** The set of plugins with some class, required feature, or layout. */
+typedef struct {
+	uintptr_t    key;      ///< Class or feature node pointer, or layout
+	LilvPlugins* plugins;  ///< Plugins with this key (not owned)
+} LilvIndexEntry;
+
+struct LilvPluginIndexImpl {
+	ZixTree* classes;   ///< Entries keyed by LilvPluginClass pointer
+	ZixTree* features;  ///< Entries keyed by required feature SordNode
+	ZixTree* layouts;   ///< Entries keyed by audio input and output counts
+};
+
+static int
+lilv_index_entry_cmp(const void* a, const void* b, void* user_data)
+{
+	const uintptr_t a_key = ((const LilvIndexEntry*)a)->key;
+	const uintptr_t b_key = ((const LilvIndexEntry*)b)->key;
+
+	return (a_key < b_key) ? -1 : (a_key > b_key) ? 1 : 0;
+}
+
+static void
+lilv_index_entry_free(void* ptr)
+{
+	LilvIndexEntry* const entry = (LilvIndexEntry*)ptr;
+	lilv_plugins_free(entry->plugins);
+	free(entry);
+}
+
+static ZixTree*
+lilv_index_new(void)
+{
+	return zix_tree_new(
+		false, lilv_index_entry_cmp, NULL, lilv_index_entry_free);
+}
+
+/** Add `plugin` to the set for `key` in `index`. */
+static void
+lilv_index_add(ZixTree* index, uintptr_t key, const LilvPlugin* plugin)
+{
+	LilvIndexEntry  search = { key, NULL };
+	LilvIndexEntry* entry  = NULL;
+	ZixTreeIter*    iter   = NULL;
+	if (!zix_tree_find(index, &search, &iter)) {
+		entry = (LilvIndexEntry*)zix_tree_get(iter);
+	} else {
+		entry          = (LilvIndexEntry*)malloc(sizeof(LilvIndexEntry));
+		entry->key     = key;
+		entry->plugins = lilv_plugins_new();
+		zix_tree_insert(index, entry, NULL);
+	}
+
+	lilv_collection_insert(entry->plugins, (LilvPlugin*)plugin);
+}
+
+static uintptr_t
+lilv_layout_key(uint32_t n_inputs, uint32_t n_outputs)
+{
+	if (n_inputs > LILV_INDEX_MAX_AUDIO_PORTS) {
+		n_inputs = LILV_INDEX_MAX_AUDIO_PORTS;
+	}
+
+	if (n_outputs > LILV_INDEX_MAX_AUDIO_PORTS) {
+		n_outputs = LILV_INDEX_MAX_AUDIO_PORTS;
+	}
+
+	return ((uintptr_t)n_inputs << 16u) | n_outputs;
+}
+
+/** Add all the plugins for entries in `index` accepted by `pred` to `set`. */
+static void
+lilv_index_collect(const ZixTree* index,
+                   LilvPlugins*   set,
+                   bool (*pred)(uintptr_t key, const void* data),
+                   const void*    data)
+{
+	for (ZixTreeIter* i = zix_tree_begin((ZixTree*)index);
+	     !zix_tree_iter_is_end(i);
+	     i = zix_tree_iter_next(i)) {
+		const LilvIndexEntry* const entry =
+			(const LilvIndexEntry*)zix_tree_get(i);
+
+		if (pred(entry->key, data)) {
+			LILV_FOREACH(plugins, p, entry->plugins) {
+				lilv_collection_insert(
+					set, (LilvPlugin*)lilv_plugins_get(entry->plugins, p));
+			}
+		}
+	}
+}
+
+static bool
+lilv_plugins_contains(const LilvPlugins* plugins, const LilvPlugin* plugin)
+{
+	return lilv_collection_find(plugins, plugin) != NULL;
+}
+
+static LilvPluginIndex*
+lilv_plugin_index_new(LilvWorld* world)
+{
+	LilvPluginIndex* const index =
+		(LilvPluginIndex*)calloc(1, sizeof(LilvPluginIndex));
+
+	index->classes  = lilv_index_new();
+	index->features = lilv_index_new();
+	index->layouts  = lilv_index_new();
+
+	LILV_FOREACH(plugins, i, world->plugins) {
+		const LilvPlugin* const plugin = lilv_plugins_get(world->plugins, i);
+
+		if (plugin->plugin_class) {
+			lilv_index_add(
+				index->classes, (uintptr_t)plugin->plugin_class, plugin);
+		}
+
+		LILV_FOREACH(nodes, f, plugin->required_features) {
+			const LilvNode* const feature =
+				lilv_nodes_get(plugin->required_features, f);
+
+			lilv_index_add(index->features, (uintptr_t)feature->node, plugin);
+		}
+
+		uint32_t n_inputs  = 0;
+		uint32_t n_outputs = 0;
+		for (uint32_t p = 0; plugin->port_table && p < plugin->num_ports; ++p) {
+			const LilvPortDescriptor* const port = &plugin->port_table[p];
+			if (port->types & LILV_PORT_TYPE_AUDIO) {
+				n_inputs += port->direction == LILV_PORT_DIRECTION_INPUT;
+				n_outputs += port->direction == LILV_PORT_DIRECTION_OUTPUT;
+			}
+		}
+
+		lilv_index_add(
+			index->layouts, lilv_layout_key(n_inputs, n_outputs), plugin);
+	}
+
+	return index;
+}
+
+void
+lilv_world_clear_plugin_index(LilvWorld* world)
+{
+	LilvPluginIndex* const index = world->plugin_index;
+	if (index) {
+		zix_tree_free(index->layouts);
+		zix_tree_free(index->features);
+		zix_tree_free(index->classes);
+		free(index);
+		world->plugin_index = NULL;
+	}
+
+	lilv_text_index_free(world->text_index);
+	world->text_index = NULL;
+}
+
+void
+lilv_world_load_plugin_index_if_necessary(LilvWorld* world)
+{
+	lilv_world_read_lock(world);
+	const bool indexed = world->plugin_index;
+	lilv_world_read_unlock(world);
+	if (indexed) {
+		return;
+	}
+
+	bool done = false;
+	while (!done) {
+		// Copy the plugin list, since loading bundles may change it meanwhile
+		lilv_world_read_lock(world);
+		const uint64_t     generation = world->generation;
+		const unsigned     n_plugins  = lilv_plugins_size(world->plugins);
+		const LilvPlugin** plugins    = (const LilvPlugin**)calloc(
+			n_plugins ? n_plugins : 1u, sizeof(const LilvPlugin*));
+		unsigned n = 0u;
+		LILV_FOREACH(plugins, i, world->plugins) {
+			plugins[n++] = lilv_plugins_get(world->plugins, i);
+		}
+		lilv_world_read_unlock(world);
+
+		// Load plugins first, since plugin locks must come before world locks
+		for (unsigned i = 0u; i < n; ++i) {
+			lilv_plugin_get_class(plugins[i]);
+			lilv_plugin_load_metadata_if_necessary(plugins[i]);
+		}
+		free(plugins);
+
+		// Build the index only if no bundle was loaded or unloaded meanwhile
+		lilv_world_write_lock(world);
+		if (world->plugin_index) {
+			done = true;
+		} else if (world->generation == generation) {
+			world->plugin_index = lilv_plugin_index_new(world);
+			done                = true;
+		}
+		lilv_world_write_unlock(world);
+	}
+}
+
+/** Search criteria for lilv_world_find_plugins(). */
+typedef struct {
+	const LilvPluginClass* plugin_class;
+	const LilvNodes*       supported_features;
+	int32_t                n_audio_inputs;
+	int32_t                n_audio_outputs;
+} LilvPluginQuery;
+
+static bool
+lilv_class_matches(uintptr_t key, const void* data)
+{
+	const LilvPluginQuery* const query = (const LilvPluginQuery*)data;
+
+	return lilv_plugin_class_is_a((const LilvPluginClass*)key,
+	                              query->plugin_class);
+}
+
+static bool
+lilv_feature_unsupported(uintptr_t key, const void* data)
+{
+	const LilvPluginQuery* const query = (const LilvPluginQuery*)data;
+
+	LILV_FOREACH(nodes, i, query->supported_features) {
+		const LilvNode* const feature =
+			lilv_nodes_get(query->supported_features, i);
+		if ((uintptr_t)feature->node == key) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool
+lilv_layout_matches(uintptr_t key, const void* data)
+{
+	const LilvPluginQuery* const query = (const LilvPluginQuery*)data;
+
+	const uint32_t n_inputs  = (uint32_t)(key >> 16u);
+	const uint32_t n_outputs = (uint32_t)(key & LILV_INDEX_MAX_AUDIO_PORTS);
+
+	return ((query->n_audio_inputs < 0 ||
+	         (uint32_t)query->n_audio_inputs == n_inputs) &&
+	        (query->n_audio_outputs < 0 ||
+	         (uint32_t)query->n_audio_outputs == n_outputs));
+}
+
+LilvPlugins*
+lilv_world_find_plugins(LilvWorld*             world,
+                        const LilvPluginClass* plugin_class,
+                        const LilvNodes*       supported_features,
+                        int32_t                n_audio_inputs,
+                        int32_t                n_audio_outputs)
+{
+	const LilvPluginQuery query = {
+		plugin_class, supported_features, n_audio_inputs, n_audio_outputs
+	};
+
+	lilv_world_load_plugin_index_if_necessary(world);
+	lilv_world_read_lock(world);
+
+	const LilvPluginIndex* const index = world->plugin_index;
+
+	// Collect the sets for every matching key of each criterion
+	LilvPlugins* classes = NULL;
+	if (plugin_class) {
+		classes = lilv_plugins_new();
+		lilv_index_collect(index->classes, classes, lilv_class_matches, &query);
+	}
+
+	LilvPlugins* layouts = NULL;
+	if (n_audio_inputs >= 0 || n_audio_outputs >= 0) {
+		layouts = lilv_plugins_new();
+		lilv_index_collect(index->layouts, layouts, lilv_layout_matches, &query);
+	}
+
+	LilvPlugins* excluded = NULL;
+	if (supported_features) {
+		excluded = lilv_plugins_new();
+		lilv_index_collect(
+			index->features, excluded, lilv_feature_unsupported, &query);
+	}
+
+	// Intersect, starting from the smallest set that must contain the result
+	const LilvPlugins* candidates = world->plugins;
+	if (classes && lilv_plugins_size(classes) < lilv_plugins_size(candidates)) {
+		candidates = classes;
+	}
+	if (layouts && lilv_plugins_size(layouts) < lilv_plugins_size(candidates)) {
+		candidates = layouts;
+	}
+
+	LilvPlugins* const result = lilv_plugins_new();
+	LILV_FOREACH(plugins, i, candidates) {
+		const LilvPlugin* const plugin = lilv_plugins_get(candidates, i);
+		if ((!classes || lilv_plugins_contains(classes, plugin)) &&
+		    (!layouts || lilv_plugins_contains(layouts, plugin)) &&
+		    (!excluded || !lilv_plugins_contains(excluded, plugin))) {
+			lilv_collection_insert(result, (LilvPlugin*)plugin);
+		}
+	}
+
+	lilv_world_read_unlock(world);
+
+	lilv_plugins_free(excluded);
+	lilv_plugins_free(layouts);
+	lilv_plugins_free(classes);
+	return result;
+}
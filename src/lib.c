@@ -28,8 +28,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-LilvLib*
-lilv_lib_open(LilvWorld*               world,
+static LilvLib*
+lilv_lib_load(LilvWorld*               world,
               const LilvNode*          uri,
               const char*              bundle_path,
               const LV2_Feature*const* features)
@@ -52,7 +52,12 @@ lilv_lib_open(LilvWorld*               world,
 	}
 
 	dlerror();
-	void* lib = dlopen(lib_path, RTLD_NOW);
+	const double start = lilv_time_now();
+	void* const  lib   = dlopen(lib_path, RTLD_NOW);
+
+	world->stats.lib_open_time += lilv_time_now() - start;
+	++world->stats.n_lib_opens;
+
 	if (!lib) {
 		LILV_ERRORF("Failed to open library %s (%s)\n", lib_path, dlerror());
 		serd_free(lib_path);
@@ -96,6 +101,18 @@ lilv_lib_open(LilvWorld*               world,
 	return llib;
 }
 
+LilvLib*
+lilv_lib_open(LilvWorld*               world,
+              const LilvNode*          uri,
+              const char*              bundle_path,
+              const LV2_Feature*const* features)
+{
+	lilv_world_lock(world);
+	LilvLib* const llib = lilv_lib_load(world, uri, bundle_path, features);
+	lilv_world_unlock(world);
+	return llib;
+}
+
 const LV2_Descriptor*
 lilv_lib_get_plugin(LilvLib* lib, uint32_t index)
 {
@@ -110,6 +127,9 @@ lilv_lib_get_plugin(LilvLib* lib, uint32_t index)
 void
 lilv_lib_close(LilvLib* lib)
 {
+	LilvWorld* const world = lib->world;
+
+	lilv_world_lock(world);
 	if (--lib->refs == 0) {
 		dlclose(lib->lib);
 
@@ -122,4 +142,5 @@ lilv_lib_close(LilvLib* lib)
 		free(lib->bundle_path);
 		free(lib);
 	}
+	lilv_world_unlock(world);
 }
@@ -33,6 +33,10 @@ extern "C" {
 #include <stdint.h>
 #include <stdio.h>
 
+#ifdef HAVE_PTHREAD
+#    include <pthread.h>
+#endif
+
 #ifdef _WIN32
 #    include <windows.h>
 #    include <direct.h>
@@ -66,7 +70,29 @@ static inline const char* dlerror(void) { return "Unknown error"; }
  *
  */
 
-typedef void LilvCollection;
+typedef struct LilvCollectionImpl LilvCollection;
+
+typedef struct LilvCacheImpl LilvCache;
+typedef struct LilvPluginIndexImpl LilvPluginIndex;
+typedef struct LilvPoolImpl LilvPool;
+typedef struct LilvQueryCacheImpl LilvQueryCache;
+typedef struct LilvTextIndexImpl LilvTextIndex;
+typedef struct LilvURIDMapImpl LilvURIDMap;
+typedef struct LilvWatchImpl LilvWatch;
+
+/**
+   A set, stored as a sorted array.
+
+   Iterators are element indices plus one, so they survive reallocation, but
+   insertion and removal shift the elements after the changed position.
+*/
+struct LilvCollectionImpl {
+	void**         elems;     ///< Elements, sorted by cmp
+	unsigned       n_elems;   ///< Number of elements
+	unsigned       capacity;  ///< Allocated size of elems
+	ZixComparator  cmp;       ///< Element comparator
+	ZixDestroyFunc destroy;   ///< Element destructor, or NULL
+};
 
 struct LilvPortImpl {
 	LilvNode*  node;     ///< RDF node
@@ -80,6 +106,7 @@ typedef struct LilvSpecImpl {
 	SordNode*            bundle;
 	LilvNodes*           data_uris;
 	struct LilvSpecImpl* next;
+	bool                 loaded;  ///< True if data files have been loaded
 } LilvSpec;
 
 /**
@@ -92,6 +119,20 @@ struct LilvHeader {
 	LilvNode*  uri;
 };
 
+/** A hash table of objects with an LilvHeader, keyed by interned URI node. */
+typedef struct {
+	struct LilvHeader** slots;      ///< Open addressing table, or NULL
+	uint32_t            n_entries;  ///< Number of entries
+	uint32_t            mask;       ///< Number of slots minus one
+} LilvURIIndex;
+
+/** A hash table of decoded literals, keyed by interned node. */
+typedef struct {
+	struct LilvLiteralImpl* slots;      ///< Open addressing table, or NULL
+	uint32_t                n_entries;  ///< Number of entries
+	uint32_t                mask;       ///< Number of slots minus one
+} LilvLiteralTable;
+
 #ifdef LILV_DYN_MANIFEST
 typedef struct {
 	LilvNode*               bundle;
@@ -111,6 +152,11 @@ typedef struct {
 	uint32_t                  refs;
 } LilvLib;
 
+typedef struct LilvVersion {
+	int minor;
+	int micro;
+} LilvVersion;
+
 struct LilvPluginImpl {
 	LilvWorld*             world;
 	LilvNode*              plugin_uri;
@@ -123,16 +169,33 @@ struct LilvPluginImpl {
 	LilvNodes*             data_uris;  ///< rdfs::seeAlso
 	LilvPort**             ports;
 	uint32_t               num_ports;
+	LilvPortDescriptor*    port_table;  ///< Summary of ports, built on demand
+	LilvPort**             port_index;  ///< Hash table of ports by symbol
+	uint32_t               port_index_mask;  ///< Number of slots, minus one
+	LilvNodes*             required_features;  ///< If metadata_loaded
+	LilvNodes*             optional_features;  ///< If metadata_loaded
+	LilvNodes*             extension_data;     ///< If metadata_loaded
+	uint32_t               latency_port;  ///< Latency port index, or -1
+	bool                   has_latency;   ///< Any port reports latency
+	bool                   metadata_loaded;
+	LilvVersion            version;  ///< Version in bundle, if version_known
 	bool                   loaded;
+	bool                   ports_loaded;  ///< Ports were loaded, maybe badly
 	bool                   parse_errors;
 	bool                   replaced;
+	bool                   version_known;
+#ifdef HAVE_PTHREAD
+	pthread_mutex_t        mutex;  ///< Guards data that is loaded on demand
+#endif
 };
 
 struct LilvPluginClassImpl {
-	LilvWorld* world;
-	LilvNode*  uri;
-	LilvNode*  parent_uri;
-	LilvNode*  label;
+	LilvWorld*             world;
+	LilvNode*              uri;
+	LilvNode*              parent_uri;
+	LilvNode*              label;
+	const LilvPluginClass* parent;    ///< Parent class, if loaded
+	LilvPluginClasses*     children;  ///< Loaded subclasses (not owned)
 };
 
 struct LilvInstancePimpl {
@@ -141,9 +204,12 @@ struct LilvInstancePimpl {
 };
 
 typedef struct {
-	bool  dyn_manifest;
-	bool  filter_language;
-	char* lv2_path;
+	bool     dyn_manifest;
+	bool     filter_language;
+	char*    lv2_path;
+	char*    discovery_cache;
+	unsigned load_threads;
+	bool     lazy_specifications;
 } LilvOptions;
 
 struct LilvWorldImpl {
@@ -151,17 +217,54 @@ struct LilvWorldImpl {
 	SordModel*         model;
 	SerdReader*        reader;
 	unsigned           n_read_files;
+	char               blank_prefix[16];  ///< Last blank node prefix
 	LilvPluginClass*   lv2_plugin_class;
 	LilvPluginClasses* plugin_classes;
+	bool               plugin_classes_loaded;
 	LilvSpec*          specs;
 	LilvPlugins*       plugins;
+	LilvURIIndex       plugin_uris;  ///< Plugins by URI node
+	LilvURIIndex       class_uris;   ///< Plugin classes by URI node
+	LilvLiteralTable   literals;     ///< Decoded values of literal nodes
 	LilvPlugins*       zombies;
 	LilvNodes*         loaded_files;
 	ZixTree*           libs;
+	LilvCache*         cache;  ///< Discovery cache during lilv_world_load_all
+	LilvWatch*         watch;  ///< Directory watch for lilv_world_poll_changes
+	LilvWorldStats     stats;  ///< Counters for lilv_world_get_stats()
+	LilvPluginIndex*   plugin_index; ///< Index for lilv_world_find_plugins()
+	LilvTextIndex*     text_index; ///< Index for lilv_world_search_plugins()
+	ZixTree*           bundle_stats; ///< Parse times by bundle URI
+	LilvURIDMap*       urid_map;     ///< Map for lilv_world_get_urid_map()
+	ZixTree*           label_cache;  ///< Preferred values of subjects
+	LilvQueryCache*    query_cache;  ///< Results of public queries, or NULL
+	uint64_t           label_generation; ///< Generation of label_cache
+	uint64_t           generation;   ///< Incremented when bundles or LANG change
+	uint64_t           query_generation; ///< Incremented when results change
+	size_t             n_quads;      ///< Model size after the last write
+	char*              lang;         ///< Normalized language for filtering
+	size_t             lang_len;     ///< Length of the language subtag
+	bool               frozen; ///< True after lilv_world_freeze()
+	LilvPool*          node_pool;         ///< Allocator for LilvNode
+	LilvPool*          port_pool;         ///< Allocator for LilvPort
+	LilvPool*          scale_point_pool;  ///< Allocator for LilvScalePoint
+#ifdef HAVE_PTHREAD
+	pthread_mutex_t    mutex;        ///< Guards sord node bookkeeping
+	pthread_rwlock_t   rwlock;       ///< Guards model and loaded state
+	pthread_key_t      read_depth;   ///< Read locks held by this thread
+	pthread_key_t      write_depth;  ///< Write locks held by this thread
+	pthread_key_t      streams;      ///< Open LilvMatches of this thread
+#endif
 	struct {
+		SordNode* atom_supports;
 		SordNode* dc_replaces;
 		SordNode* dman_DynManifest;
+		SordNode* doap_maintainer;
 		SordNode* doap_name;
+		SordNode* ev_supportsEvent;
+		SordNode* foaf_homepage;
+		SordNode* foaf_mbox;
+		SordNode* foaf_name;
 		SordNode* lv2_Plugin;
 		SordNode* lv2_Specification;
 		SordNode* lv2_appliesTo;
@@ -179,10 +282,12 @@ struct LilvWorldImpl {
 		SordNode* lv2_optionalFeature;
 		SordNode* lv2_port;
 		SordNode* lv2_portProperty;
+		SordNode* lv2_project;
 		SordNode* lv2_reportsLatency;
 		SordNode* lv2_requiredFeature;
 		SordNode* lv2_symbol;
 		SordNode* lv2_prototype;
+		SordNode* lv2_scalePoint;
 		SordNode* owl_Ontology;
 		SordNode* pset_value;
 		SordNode* rdf_a;
@@ -191,6 +296,8 @@ struct LilvWorldImpl {
 		SordNode* rdfs_label;
 		SordNode* rdfs_seeAlso;
 		SordNode* rdfs_subClassOf;
+		SordNode* ui_binary;
+		SordNode* ui_ui;
 		SordNode* xsd_base64Binary;
 		SordNode* xsd_boolean;
 		SordNode* xsd_decimal;
@@ -215,6 +322,7 @@ struct LilvNodeImpl {
 	LilvWorld*   world;
 	SordNode*    node;
 	LilvNodeType type;
+	bool         borrowed;  ///< Node is kept alive by a frozen world
 	union {
 		int   int_val;
 		float float_val;
@@ -235,11 +343,6 @@ struct LilvUIImpl {
 	LilvNodes* classes;
 };
 
-typedef struct LilvVersion {
-	int minor;
-	int micro;
-} LilvVersion;
-
 /*
  *
  * Functions
@@ -251,6 +354,9 @@ LilvPort* lilv_port_new(LilvWorld*      world,
                         uint32_t        index,
                         const char*     symbol);
 void      lilv_port_free(const LilvPlugin* plugin, LilvPort* port);
+void      lilv_port_get_descriptor(const LilvPlugin*   plugin,
+                                   const LilvPort*     port,
+                                   LilvPortDescriptor* desc);
 
 LilvPlugin* lilv_plugin_new(LilvWorld* world,
                             LilvNode*  uri,
@@ -262,11 +368,40 @@ LilvNode*   lilv_plugin_get_unique(const LilvPlugin* plugin,
                                    const SordNode*   subject,
                                    const SordNode*   predicate);
 
-void      lilv_collection_free(LilvCollection* collection);
-unsigned  lilv_collection_size(const LilvCollection* collection);
-LilvIter* lilv_collection_begin(const LilvCollection* collection);
-void*     lilv_collection_get(const LilvCollection* collection,
-                              const LilvIter*       i);
+LilvCollection* lilv_collection_new(ZixComparator  cmp,
+                                    ZixDestroyFunc destructor);
+void            lilv_collection_free(LilvCollection* collection);
+unsigned        lilv_collection_size(const LilvCollection* collection);
+LilvIter*       lilv_collection_begin(const LilvCollection* collection);
+void*           lilv_collection_get(const LilvCollection* collection,
+                                    const LilvIter*       i);
+LilvIter*       lilv_collection_next(const LilvCollection* collection,
+                                     LilvIter*             i);
+bool            lilv_collection_is_end(const LilvCollection* collection,
+                                       const LilvIter*       i);
+
+/**
+   Insert `elem` into `collection`, keeping it sorted.
+
+   @return ZIX_STATUS_EXISTS, without taking ownership of `elem`, if an equal
+   element is already present.
+*/
+ZixStatus lilv_collection_insert(LilvCollection* collection, void* elem);
+
+/** Return an iterator to the element equal to `key`, or NULL. */
+LilvIter* lilv_collection_find(const LilvCollection* collection,
+                               const void*           key);
+
+/** Return an iterator to the first element not less than `key`. */
+LilvIter* lilv_collection_lower_bound(const LilvCollection* collection,
+                                      const void*           key);
+
+/**
+   Remove and destroy the element at `i`.
+
+   Later elements move down, so `i` then refers to the following element.
+*/
+void lilv_collection_remove(LilvCollection* collection, LilvIter* i);
 
 LilvPluginClass* lilv_plugin_class_new(LilvWorld*      world,
                                        const SordNode* parent_node,
@@ -275,6 +410,9 @@ LilvPluginClass* lilv_plugin_class_new(LilvWorld*      world,
 
 void lilv_plugin_class_free(LilvPluginClass* plugin_class);
 
+/** Link plugin classes without a parent to their parent, if it is loaded. */
+void lilv_plugin_classes_link(LilvWorld* world);
+
 LilvLib*
 lilv_lib_open(LilvWorld*               world,
               const LilvNode*          uri,
@@ -293,17 +431,151 @@ LilvUIs*           lilv_uis_new(void);
 LilvNode* lilv_world_get_manifest_uri(LilvWorld*      world,
                                       const LilvNode* bundle_uri);
 
+/**
+   Return a new blank node prefix for reading a file.
+
+   The returned string is only valid until the next call.
+*/
 const uint8_t* lilv_world_blank_node_prefix(LilvWorld* world);
 
 SerdStatus lilv_world_load_file(LilvWorld*      world,
                                 SerdReader*     reader,
                                 const LilvNode* uri);
 
+LilvVersion lilv_world_get_version(LilvWorld*      world,
+                                   SordModel*      model,
+                                   const SordNode* subject);
+
 SerdStatus
 lilv_world_load_graph(LilvWorld*      world,
                       SordNode*       graph,
                       const LilvNode* uri);
 
+/** Return the LV2 path for the world, from options, environment, or default. */
+const char* lilv_world_get_lv2_path(const LilvWorld* world);
+
+void
+lilv_world_for_each_path_dir(const char* lv2_path,
+                             void*       data,
+                             void (*f)(const char*, void*));
+
+void lilv_watch_free(LilvWatch* watch);
+
+/** Load any specifications that `node` is in, if loading them lazily. */
+void lilv_world_load_namespace(LilvWorld* world, const SordNode* node);
+
+/** Load plugin classes if they have not been loaded yet. */
+void lilv_world_load_plugin_classes_if_necessary(LilvWorld* world);
+
+/**
+   Lock the world while touching shared sord node state.
+
+   Even queries change sord state: node reference counts, the count of live
+   iterators, and the set of interned nodes, which must not race.  This lock
+   is recursive and only held briefly, it is always the innermost lock.
+*/
+void lilv_world_lock(LilvWorld* world);
+
+/** Unlock the world after lilv_world_lock(). */
+void lilv_world_unlock(LilvWorld* world);
+
+/**
+   Lock the world model for reading.
+
+   This is held for the lifetime of every iterator on the model, so loading
+   can not change the model while it is being searched.  It does nothing if
+   the world is frozen or the calling thread holds the write lock.  This is
+   recursive, and only the outermost call locks, since a thread that locks
+   for reading again could otherwise wait behind a writer waiting for it.  A
+   thread that holds a read lock may only take the write lock if its only
+   open model iterators are in streams, which are suspended meanwhile.
+*/
+void lilv_world_read_lock(LilvWorld* world);
+
+/** Unlock the world model after lilv_world_read_lock(). */
+void lilv_world_read_unlock(LilvWorld* world);
+
+/**
+   Lock the world for loading data into the model.
+
+   This is recursive, excludes all readers, and also holds lilv_world_lock(),
+   since adding statements changes node reference counts.  Per-plugin locks
+   must be taken before this, never after.
+*/
+void lilv_world_write_lock(LilvWorld* world);
+
+/** Unlock the world after lilv_world_write_lock(). */
+void lilv_world_write_unlock(LilvWorld* world);
+
+/** Free an iterator returned by lilv_world_query_internal(). */
+void lilv_world_iter_free(LilvWorld* world, SordIter* iter);
+
+/** Load everything about a plugin that would otherwise be loaded on demand. */
+void lilv_plugin_load_all(LilvPlugin* plugin);
+
+/** Load the features, extension data, and latency port of a plugin. */
+void lilv_plugin_load_metadata_if_necessary(const LilvPlugin* plugin);
+
+/** Build the plugin index, loading every plugin, if it has been dropped. */
+void lilv_world_load_plugin_index_if_necessary(LilvWorld* world);
+
+/** Drop the plugin indexes, after plugins have been added or removed. */
+void lilv_world_clear_plugin_index(LilvWorld* world);
+
+/** Build the index for lilv_world_search_plugins() if it has been dropped. */
+void lilv_world_load_text_index_if_necessary(LilvWorld* world);
+
+void lilv_text_index_free(LilvTextIndex* index);
+
+LilvURIDMap* lilv_urid_map_new(LilvWorld* world);
+void         lilv_urid_map_free(LilvURIDMap* map);
+
+/** Forget all decoded literals, so the nodes they refer to may be freed. */
+void lilv_world_clear_literals(LilvWorld* world);
+
+/**
+   Decode every literal in the model, before the world is frozen.
+
+   Literals in a frozen world are then found without locking, since the table
+   of decoded literals never changes.
+*/
+void lilv_world_decode_literals(LilvWorld* world);
+
+/** Create a pool of objects which are `size` bytes large. */
+LilvPool* lilv_pool_new(size_t size);
+
+/** Free `pool` and every object allocated from it. */
+void lilv_pool_free(LilvPool* pool);
+
+/** Allocate an object from `pool`, or return NULL. */
+void* lilv_pool_alloc(LilvPool* pool);
+
+/** Return `obj`, which was allocated from `pool`, for reuse. */
+void lilv_pool_release(LilvPool* pool, void* obj);
+
+LilvCache* lilv_cache_new(LilvWorld* world, const char* path);
+void       lilv_cache_free(LilvCache* cache);
+int        lilv_cache_write(const LilvCache* cache);
+
+/**
+   Check if a bundle is unchanged since it was cached.
+
+   This records the current state of the bundle, so must be called before the
+   bundle is read, whether it is restored from the cache or not.
+*/
+bool
+lilv_cache_check_bundle(LilvCache*      cache,
+                        const char*     bundle_path,
+                        const SordNode* bundle);
+
+/** Add the cached manifest statements of a checked bundle to the world. */
+void
+lilv_cache_restore_bundle(LilvCache* cache, const SordNode* bundle);
+
+/** Record the manifest statements of a freshly read bundle. */
+void
+lilv_cache_capture_bundle(LilvCache* cache, const SordNode* bundle);
+
 LilvUI* lilv_ui_new(LilvWorld* world,
                     LilvNode*  uri,
                     LilvNode*  type_uri,
@@ -314,6 +586,15 @@ void lilv_ui_free(LilvUI* ui);
 LilvNode* lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str);
 LilvNode* lilv_node_new_from_node(LilvWorld* world, const SordNode* node);
 
+/**
+   Make `view` refer to `node` without copying it, or return false on error.
+
+   The view borrows from the model, so it is only valid while the world read
+   lock is held, and must not be freed.  Duplicating it makes a real node.
+*/
+bool
+lilv_node_set_view(LilvNode* view, LilvWorld* world, const SordNode* node);
+
 int lilv_header_compare_by_uri(const void* a, const void* b, void* user_data);
 int lilv_lib_compare(const void* a, const void* b, void* user_data);
 
@@ -334,7 +615,15 @@ lilv_version_cmp(const LilvVersion* a, const LilvVersion* b)
 }
 
 struct LilvHeader*
-lilv_collection_get_by_uri(const ZixTree* seq, const LilvNode* uri);
+lilv_collection_get_by_uri(const LilvCollection* seq, const LilvNode* uri);
+
+void lilv_uri_index_insert(LilvURIIndex* index, struct LilvHeader* header);
+void lilv_uri_index_remove(LilvURIIndex*            index,
+                           const struct LilvHeader* header);
+void lilv_uri_index_free(LilvURIIndex* index);
+
+struct LilvHeader*
+lilv_uri_index_get(const LilvURIIndex* index, const SordNode* node);
 
 LilvScalePoint* lilv_scale_point_new(LilvNode* value, LilvNode* label);
 void            lilv_scale_point_free(LilvScalePoint* point);
@@ -357,6 +646,64 @@ lilv_world_find_nodes_internal(LilvWorld*      world,
                                const SordNode* predicate,
                                const SordNode* object);
 
+/**
+   Return the first value of `predicate` on `subject`, or NULL.
+
+   This is the first of lilv_world_find_nodes_internal(), but remembered until
+   the world changes, for names and labels which are queried often.
+*/
+LilvNode*
+lilv_world_get_preferred_value(LilvWorld*      world,
+                               const SordNode* subject,
+                               const SordNode* predicate);
+
+/**
+   Return the remembered first value of `predicate` on `subject`, or NULL.
+
+   Like lilv_world_get_preferred_value(), but the returned node is owned by
+   the world and valid until the world or its language changes.
+*/
+const LilvNode*
+lilv_world_borrow_preferred_value(LilvWorld*      world,
+                                  const SordNode* subject,
+                                  const SordNode* predicate);
+
+/** Drop all values remembered by lilv_world_get_preferred_value(). */
+void lilv_world_clear_label_cache(LilvWorld* world);
+
+/** Create a cache that remembers the results of `size` queries. */
+LilvQueryCache* lilv_query_cache_new(unsigned size);
+
+void lilv_query_cache_free(LilvWorld* world, LilvQueryCache* cache);
+
+/**
+   Find nodes like lilv_world_find_nodes_internal(), using the query cache.
+
+   If `first_only` is true, then the result has at most one value, the one
+   lilv_world_get() returns.
+*/
+LilvNodes*
+lilv_world_find_nodes_cached(LilvWorld*      world,
+                             const SordNode* subject,
+                             const SordNode* predicate,
+                             const SordNode* object,
+                             bool            first_only);
+
+/** Ask like lilv_world_ask_internal(), using the query cache. */
+bool
+lilv_world_ask_cached(LilvWorld*      world,
+                      const SordNode* subject,
+                      const SordNode* predicate,
+                      const SordNode* object);
+
+/**
+   Return the language for language filtering, or NULL.
+
+   The length of the language part of the result, before any dash, is stored
+   in `lang_len`.
+*/
+const char* lilv_world_get_lang(LilvWorld* world, size_t* lang_len);
+
 SordModel*
 lilv_world_filter_model(LilvWorld*      world,
                         SordModel*      model,
@@ -372,11 +719,34 @@ LilvNodes* lilv_nodes_from_stream_objects(LilvWorld*    world,
                                           SordIter*     stream,
                                           SordQuadIndex field);
 
+/**
+   Return a stream of the `field` nodes of statements matching a pattern.
+
+   The stream holds the world read lock until it is freed, but is suspended
+   if the calling thread takes the write lock meanwhile.
+*/
+LilvMatches*
+lilv_matches_new(LilvWorld*      world,
+                 const SordNode* subject,
+                 const SordNode* predicate,
+                 const SordNode* object,
+                 SordQuadIndex   field);
+
+/**
+   Stop the streams of the calling thread from reading the model.
+
+   This is called before the thread writes to the model, and each stream
+   searches again from its current statement when it is next used.
+*/
+void
+lilv_world_suspend_streams(LilvWorld* world);
+
 char*  lilv_strjoin(const char* first, ...);
 char*  lilv_strdup(const char* str);
-char*  lilv_get_lang(void);
+char*  lilv_normalize_lang(const char* env_lang);
 char*  lilv_expand(const char* path);
 char*  lilv_get_latest_copy(const char* path, const char* copy_path);
+double lilv_time_now(void);
 
 char*
 lilv_find_free_path(const char* in_path,
@@ -59,10 +59,12 @@ lilv_node_set_numerics_from_string(LilvNode* val)
 LilvNode*
 lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str)
 {
-	LilvNode* val = (LilvNode*)malloc(sizeof(LilvNode));
-	val->world = world;
-	val->type  = type;
+	LilvNode* val = (LilvNode*)lilv_pool_alloc(world->node_pool);
+	val->world    = world;
+	val->type     = type;
+	val->borrowed = false;
 
+	lilv_world_lock(world);
 	const uint8_t* ustr = (const uint8_t*)str;
 	switch (type) {
 	case LILV_VALUE_URI:
@@ -91,15 +93,243 @@ lilv_node_new(LilvWorld* world, LilvNodeType type, const char* str)
 			world->world, world->uris.xsd_base64Binary, ustr, NULL);
 		break;
 	}
+	lilv_world_unlock(world);
 
 	if (!val->node) {
-		free(val);
+		lilv_pool_release(world->node_pool, val);
 		return NULL;
 	}
 
 	return val;
 }
 
+/**
+   Refer to a node in the world, which is either copied, or borrowed if the
+   world is frozen and therefore keeps it alive until it is destroyed.
+*/
+static void
+lilv_node_set_resource(LilvNode* val, const SordNode* node)
+{
+	val->borrowed = val->world->frozen;
+	if (val->borrowed) {
+		val->node = (SordNode*)node;
+	} else {
+		lilv_world_lock(val->world);
+		val->node = sord_node_copy(node);
+		lilv_world_unlock(val->world);
+	}
+}
+
+/** A literal node and the LilvNode made from it, decoded once. */
+struct LilvLiteralImpl {
+	const SordNode* literal;  ///< Literal in the model, or NULL if empty
+	LilvNode        value;    ///< Decoded value, which owns its node
+};
+
+typedef struct LilvLiteralImpl LilvLiteral;
+
+/** Return the first slot to probe for `node`, which is interned. */
+static uint32_t
+lilv_literal_slot(const LilvLiteralTable* table, const SordNode* node)
+{
+	const uint32_t h = (uint32_t)((uintptr_t)node >> 4u);
+	return (h * 2654435761u) & table->mask;
+}
+
+static LilvLiteral*
+lilv_literal_find(const LilvLiteralTable* table, const SordNode* node)
+{
+	if (!table->slots) {
+		return NULL;
+	}
+
+	for (uint32_t s = lilv_literal_slot(table, node); table->slots[s].literal;
+	     s = (s + 1u) & table->mask) {
+		if (table->slots[s].literal == node) {
+			return &table->slots[s];
+		}
+	}
+
+	return NULL;
+}
+
+static LilvLiteral*
+lilv_literal_place(LilvLiteralTable* table, const LilvLiteral* literal)
+{
+	uint32_t s = lilv_literal_slot(table, literal->literal);
+	while (table->slots[s].literal) {
+		s = (s + 1u) & table->mask;
+	}
+
+	table->slots[s] = *literal;
+	return &table->slots[s];
+}
+
+/** Return the type of LilvNode that represents the literal `node`. */
+static LilvNodeType
+lilv_literal_type(const LilvWorld* world, const SordNode* node)
+{
+	const SordNode* const datatype_uri = sord_node_get_datatype(node);
+	if (!datatype_uri) {
+		return LILV_VALUE_STRING;
+	} else if (sord_node_equals(datatype_uri, world->uris.xsd_boolean)) {
+		return LILV_VALUE_BOOL;
+	} else if (sord_node_equals(datatype_uri, world->uris.xsd_decimal) ||
+	           sord_node_equals(datatype_uri, world->uris.xsd_double)) {
+		return LILV_VALUE_FLOAT;
+	} else if (sord_node_equals(datatype_uri, world->uris.xsd_integer)) {
+		return LILV_VALUE_INT;
+	} else if (sord_node_equals(datatype_uri, world->uris.xsd_base64Binary)) {
+		return LILV_VALUE_BLOB;
+	}
+
+	LILV_ERRORF("Unknown datatype `%s'\n", sord_node_get_string(datatype_uri));
+	return LILV_VALUE_STRING;
+}
+
+/**
+   Decode the literal `node` and remember it, or return NULL on error.
+
+   This must be called with the world mutex held.
+*/
+static const LilvLiteral*
+lilv_literal_insert(LilvWorld* world, const SordNode* node)
+{
+	LilvLiteralTable* const table = &world->literals;
+
+	LilvNode* const value =
+		lilv_node_new(world,
+		              lilv_literal_type(world, node),
+		              (const char*)sord_node_get_string(node));
+	if (!value) {
+		return NULL;
+	}
+
+	lilv_node_set_numerics_from_string(value);
+
+	// Grow to keep the table at most half full
+	if (!table->slots || (table->n_entries + 1u) * 2u > table->mask + 1u) {
+		LilvLiteral* const old_slots = table->slots;
+		const uint32_t     old_size  = old_slots ? table->mask + 1u : 0u;
+		const uint32_t     new_size  = old_size ? old_size * 2u : 64u;
+
+		table->slots = (LilvLiteral*)calloc(new_size, sizeof(LilvLiteral));
+		table->mask  = new_size - 1u;
+		for (uint32_t i = 0u; i < old_size; ++i) {
+			if (old_slots[i].literal) {
+				lilv_literal_place(table, &old_slots[i]);
+			}
+		}
+
+		free(old_slots);
+	}
+
+	// Move the value into the table, which keeps both nodes alive
+	const LilvLiteral entry = {sord_node_copy(node), *value};
+	lilv_pool_release(world->node_pool, value);
+	++table->n_entries;
+
+	return lilv_literal_place(table, &entry);
+}
+
+void
+lilv_world_clear_literals(LilvWorld* world)
+{
+	LilvLiteralTable* const table = &world->literals;
+	if (!table->slots) {
+		return;
+	}
+
+	lilv_world_lock(world);
+	for (uint32_t i = 0u; i <= table->mask; ++i) {
+		if (table->slots[i].literal) {
+			sord_node_free(world->world, table->slots[i].value.node);
+			sord_node_free(world->world, (SordNode*)table->slots[i].literal);
+		}
+	}
+
+	free(table->slots);
+	table->slots     = NULL;
+	table->n_entries = 0u;
+	table->mask      = 0u;
+	lilv_world_unlock(world);
+}
+
+void
+lilv_world_decode_literals(LilvWorld* world)
+{
+	lilv_world_lock(world);
+	SordIter* i = sord_begin(world->model);
+	FOREACH_MATCH(i) {
+		const SordNode* const node = sord_iter_get_node(i, SORD_OBJECT);
+		if (sord_node_get_type(node) == SORD_LITERAL &&
+		    !lilv_literal_find(&world->literals, node)) {
+			lilv_literal_insert(world, node);
+		}
+	}
+	sord_iter_free(i);
+	lilv_world_unlock(world);
+}
+
+/**
+   Decode a literal that is not in the table of a frozen world.
+
+   This does not touch the table, which other threads read without locking.
+*/
+static LilvNode*
+lilv_node_new_from_frozen_literal(LilvWorld* world, const SordNode* node)
+{
+	lilv_world_lock(world);
+	LilvNode* const result =
+		lilv_node_new(world,
+		              lilv_literal_type(world, node),
+		              (const char*)sord_node_get_string(node));
+	lilv_world_unlock(world);
+
+	if (result) {
+		lilv_node_set_numerics_from_string(result);
+	}
+
+	return result;
+}
+
+/** Create a new LilvNode from a literal, decoding it only the first time. */
+static LilvNode*
+lilv_node_new_from_literal(LilvWorld* world, const SordNode* node)
+{
+	LilvNode* result = NULL;
+
+	if (world->frozen) {
+		// The table is complete and never changes, so no lock is needed
+		const LilvLiteral* literal = lilv_literal_find(&world->literals, node);
+		if (!literal) {
+			return lilv_node_new_from_frozen_literal(world, node);
+		}
+
+		result           = (LilvNode*)lilv_pool_alloc(world->node_pool);
+		*result          = literal->value;
+		result->borrowed = true;
+		return result;
+	}
+
+	lilv_world_lock(world);
+	const LilvLiteral* literal = lilv_literal_find(&world->literals, node);
+	if (!literal) {
+		literal = lilv_literal_insert(world, node);
+	}
+
+	if (literal) {
+		result  = (LilvNode*)lilv_pool_alloc(world->node_pool);
+		*result = literal->value;
+
+		result->borrowed = false;
+		result->node     = sord_node_copy(literal->value.node);
+	}
+	lilv_world_unlock(world);
+
+	return result;
+}
+
 /** Create a new LilvNode from `node`, or return NULL if impossible */
 LilvNode*
 lilv_node_new_from_node(LilvWorld* world, const SordNode* node)
@@ -108,50 +338,69 @@ lilv_node_new_from_node(LilvWorld* world, const SordNode* node)
 		return NULL;
 	}
 
-	LilvNode*    result       = NULL;
-	SordNode*    datatype_uri = NULL;
-	LilvNodeType type         = LILV_VALUE_STRING;
+	LilvNode* result = NULL;
 
 	switch (sord_node_get_type(node)) {
 	case SORD_URI:
-		result        = (LilvNode*)malloc(sizeof(LilvNode));
+		result        = (LilvNode*)lilv_pool_alloc(world->node_pool);
 		result->world = world;
 		result->type  = LILV_VALUE_URI;
-		result->node  = sord_node_copy(node);
+		lilv_node_set_resource(result, node);
 		break;
 	case SORD_BLANK:
-		result        = (LilvNode*)malloc(sizeof(LilvNode));
+		result        = (LilvNode*)lilv_pool_alloc(world->node_pool);
 		result->world = world;
 		result->type  = LILV_VALUE_BLANK;
-		result->node  = sord_node_copy(node);
+		lilv_node_set_resource(result, node);
 		break;
 	case SORD_LITERAL:
-		datatype_uri = sord_node_get_datatype(node);
-		if (datatype_uri) {
-			if (sord_node_equals(datatype_uri, world->uris.xsd_boolean)) {
-				type = LILV_VALUE_BOOL;
-			} else if (sord_node_equals(datatype_uri, world->uris.xsd_decimal) ||
-			           sord_node_equals(datatype_uri, world->uris.xsd_double)) {
-				type = LILV_VALUE_FLOAT;
-			} else if (sord_node_equals(datatype_uri, world->uris.xsd_integer)) {
-				type = LILV_VALUE_INT;
-			} else if (sord_node_equals(datatype_uri,
-			                            world->uris.xsd_base64Binary)) {
-				type = LILV_VALUE_BLOB;
-			} else {
-				LILV_ERRORF("Unknown datatype `%s'\n",
-				            sord_node_get_string(datatype_uri));
-			}
-		}
-		result = lilv_node_new(
-			world, type, (const char*)sord_node_get_string(node));
-		lilv_node_set_numerics_from_string(result);
+		result = lilv_node_new_from_literal(world, node);
 		break;
 	}
 
 	return result;
 }
 
+bool
+lilv_node_set_view(LilvNode* view, LilvWorld* world, const SordNode* node)
+{
+	view->world    = world;
+	view->borrowed = true;
+
+	switch (sord_node_get_type(node)) {
+	case SORD_URI:
+		view->type = LILV_VALUE_URI;
+		view->node = (SordNode*)node;
+		return true;
+	case SORD_BLANK:
+		view->type = LILV_VALUE_BLANK;
+		view->node = (SordNode*)node;
+		return true;
+	case SORD_LITERAL:
+		break;
+	}
+
+	const LilvLiteral* literal = NULL;
+	if (world->frozen) {
+		// Every literal in the model was decoded by lilv_world_freeze()
+		literal = lilv_literal_find(&world->literals, node);
+	} else {
+		lilv_world_lock(world);
+		literal = lilv_literal_find(&world->literals, node);
+		if (!literal) {
+			literal = lilv_literal_insert(world, node);
+		}
+		lilv_world_unlock(world);
+	}
+
+	if (literal) {
+		*view          = literal->value;
+		view->borrowed = true;
+	}
+
+	return literal != NULL;
+}
+
 LilvNode*
 lilv_new_uri(LilvWorld* world, const char* uri)
 {
@@ -219,11 +468,18 @@ lilv_node_duplicate(const LilvNode* val)
 		return NULL;
 	}
 
-	LilvNode* result = (LilvNode*)malloc(sizeof(LilvNode));
-	result->world = val->world;
-	result->node  = sord_node_copy(val->node);
-	result->val   = val->val;
-	result->type  = val->type;
+	LilvNode* result = (LilvNode*)lilv_pool_alloc(val->world->node_pool);
+	result->world    = val->world;
+	result->val      = val->val;
+	result->type     = val->type;
+	result->borrowed = val->borrowed && val->world->frozen;
+	if (result->borrowed) {
+		result->node = val->node;
+	} else {
+		lilv_world_lock(val->world);
+		result->node = sord_node_copy(val->node);
+		lilv_world_unlock(val->world);
+	}
 	return result;
 }
 
@@ -231,8 +487,12 @@ void
 lilv_node_free(LilvNode* val)
 {
 	if (val) {
-		sord_node_free(val->world->world, val->node);
-		free(val);
+		if (!val->borrowed) {
+			lilv_world_lock(val->world);
+			sord_node_free(val->world->world, val->node);
+			lilv_world_unlock(val->world);
+		}
+		lilv_pool_release(val->world->node_pool, val);
 	}
 }
 
@@ -19,16 +19,13 @@
 #include "lilv/lilv.h"
 #include "serd/serd.h"
 #include "sord/sord.h"
-#include "zix/tree.h"
 
 #include "lv2/core/lv2.h"
-#include "lv2/ui/ui.h"
 
 #ifdef LILV_DYN_MANIFEST
 #    include "lv2/dynmanifest/dynmanifest.h"
 #endif
 
-#include <math.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -36,24 +33,34 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define NS_DOAP (const uint8_t*)"http://usefulinc.com/ns/doap#"
-#define NS_FOAF (const uint8_t*)"http://xmlns.com/foaf/0.1/"
-
 static void
 lilv_plugin_init(LilvPlugin* plugin, LilvNode* bundle_uri)
 {
-	plugin->bundle_uri   = bundle_uri;
-	plugin->binary_uri   = NULL;
+	plugin->bundle_uri    = bundle_uri;
+	plugin->binary_uri    = NULL;
 #ifdef LILV_DYN_MANIFEST
-	plugin->dynmanifest  = NULL;
+	plugin->dynmanifest   = NULL;
 #endif
-	plugin->plugin_class = NULL;
-	plugin->data_uris    = lilv_nodes_new();
-	plugin->ports        = NULL;
-	plugin->num_ports    = 0;
-	plugin->loaded       = false;
-	plugin->parse_errors = false;
-	plugin->replaced     = false;
+	plugin->plugin_class  = NULL;
+	plugin->data_uris     = lilv_nodes_new();
+	plugin->ports         = NULL;
+	plugin->num_ports     = 0;
+	plugin->port_table    = NULL;
+	plugin->port_index    = NULL;
+
+	plugin->required_features = NULL;
+	plugin->optional_features = NULL;
+	plugin->extension_data    = NULL;
+	plugin->latency_port      = (uint32_t)-1;
+	plugin->has_latency       = false;
+	plugin->metadata_loaded   = false;
+	plugin->version.minor = 0;
+	plugin->version.micro = 0;
+	plugin->loaded        = false;
+	plugin->ports_loaded  = false;
+	plugin->parse_errors  = false;
+	plugin->replaced      = false;
+	plugin->version_known = false;
 }
 
 /** Ownership of `uri` and `bundle` is taken */
@@ -65,16 +72,37 @@ lilv_plugin_new(LilvWorld* world, LilvNode* uri, LilvNode* bundle_uri)
 	plugin->world      = world;
 	plugin->plugin_uri = uri;
 
+#ifdef HAVE_PTHREAD
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&plugin->mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+#endif
+
 	lilv_plugin_init(plugin, bundle_uri);
 	return plugin;
 }
 
+static void
+lilv_plugin_free_metadata(LilvPlugin* plugin)
+{
+	lilv_nodes_free(plugin->extension_data);
+	lilv_nodes_free(plugin->optional_features);
+	lilv_nodes_free(plugin->required_features);
+	plugin->extension_data    = NULL;
+	plugin->optional_features = NULL;
+	plugin->required_features = NULL;
+	plugin->metadata_loaded   = false;
+}
+
 void
 lilv_plugin_clear(LilvPlugin* plugin, LilvNode* bundle_uri)
 {
 	lilv_node_free(plugin->bundle_uri);
 	lilv_node_free(plugin->binary_uri);
 	lilv_nodes_free(plugin->data_uris);
+	lilv_plugin_free_metadata(plugin);
 	lilv_plugin_init(plugin, bundle_uri);
 }
 
@@ -89,6 +117,12 @@ lilv_plugin_free_ports(LilvPlugin* plugin)
 		plugin->num_ports = 0;
 		plugin->ports     = NULL;
 	}
+
+	free(plugin->port_table);
+	plugin->port_table = NULL;
+
+	free(plugin->port_index);
+	plugin->port_index = NULL;
 }
 
 void
@@ -110,13 +144,45 @@ lilv_plugin_free(LilvPlugin* plugin)
 	plugin->binary_uri = NULL;
 
 	lilv_plugin_free_ports(plugin);
+	lilv_plugin_free_metadata(plugin);
 
 	lilv_nodes_free(plugin->data_uris);
 	plugin->data_uris = NULL;
 
+#ifdef HAVE_PTHREAD
+	pthread_mutex_destroy(&plugin->mutex);
+#endif
+
 	free(plugin);
 }
 
+/**
+   Lock the data of `plugin` that is loaded on demand.
+
+   This ensures that concurrent queries load each plugin only once, while
+   different plugins may be loaded by different threads.  Nothing is loaded
+   after the world is frozen, so no lock is needed then.
+*/
+static void
+lilv_plugin_lock(const LilvPlugin* plugin)
+{
+#ifdef HAVE_PTHREAD
+	if (!plugin->world->frozen) {
+		pthread_mutex_lock(&((LilvPlugin*)plugin)->mutex);
+	}
+#endif
+}
+
+static void
+lilv_plugin_unlock(const LilvPlugin* plugin)
+{
+#ifdef HAVE_PTHREAD
+	if (!plugin->world->frozen) {
+		pthread_mutex_unlock(&((LilvPlugin*)plugin)->mutex);
+	}
+#endif
+}
+
 static LilvNode*
 lilv_plugin_get_one(const LilvPlugin* plugin,
                     const SordNode*   subject,
@@ -164,6 +230,8 @@ lilv_plugin_load(LilvPlugin* plugin)
 	SerdReader* reader = sord_new_reader(plugin->world->model, env, SERD_TURTLE,
 	                                     bundle_uri_node);
 
+	++plugin->world->stats.n_plugin_loads;
+
 	SordModel* prots = lilv_world_filter_model(
 		plugin->world,
 		plugin->world->model,
@@ -247,6 +315,13 @@ lilv_plugin_load(LilvPlugin* plugin)
 	serd_reader_free(reader);
 	serd_env_free(env);
 
+	if (!plugin->version_known) {
+		// Record version for later replacement checks while data is loaded
+		plugin->version = lilv_world_get_version(
+			plugin->world, plugin->world->model, plugin->plugin_uri->node);
+		plugin->version_known = true;
+	}
+
 	plugin->loaded = true;
 }
 
@@ -264,14 +339,55 @@ is_symbol(const char* str)
 	return true;
 }
 
+/**
+   Return the first slot to probe for a symbol in the port index.
+
+   Symbol nodes are interned, so equal symbols have the same node pointer.
+*/
+static uint32_t
+lilv_plugin_port_slot(const LilvPlugin* plugin, const LilvNode* symbol)
+{
+	const uint32_t h = (uint32_t)((uintptr_t)symbol->node >> 4u);
+	return (h * 2654435761u) & plugin->port_index_mask;
+}
+
+/** Build the port index, a hash table with at least twice as many slots. */
+static void
+lilv_plugin_index_ports(LilvPlugin* plugin)
+{
+	uint32_t n_slots = 2u;
+	while (n_slots < plugin->num_ports * 2u) {
+		n_slots *= 2u;
+	}
+
+	plugin->port_index      = (LilvPort**)calloc(n_slots, sizeof(LilvPort*));
+	plugin->port_index_mask = n_slots - 1u;
+
+	for (uint32_t i = 0; i < plugin->num_ports; ++i) {
+		LilvPort* const port = plugin->ports[i];
+		uint32_t        s    = lilv_plugin_port_slot(plugin, port->symbol);
+		while (plugin->port_index[s] &&
+		       !lilv_node_equals(plugin->port_index[s]->symbol, port->symbol)) {
+			s = (s + 1u) & plugin->port_index_mask;
+		}
+
+		if (!plugin->port_index[s]) {
+			plugin->port_index[s] = port;  // First port with this symbol wins
+		}
+	}
+}
+
 static void
 lilv_plugin_load_ports_if_necessary(const LilvPlugin* const_plugin)
 {
 	LilvPlugin* plugin = (LilvPlugin*)const_plugin;
 
+	lilv_plugin_lock(plugin);
 	lilv_plugin_load_if_necessary(plugin);
 
-	if (!plugin->ports) {
+	// Invalid ports are freed, but never loaded again
+	if (!plugin->ports_loaded) {
+		plugin->ports_loaded = true;
 		plugin->ports = (LilvPort**)malloc(sizeof(LilvPort*));
 		plugin->ports[0] = NULL;
 
@@ -334,20 +450,20 @@ lilv_plugin_load_ports_if_necessary(const LilvPlugin* const_plugin)
 			FOREACH_MATCH(types) {
 				const SordNode* type = sord_iter_get_node(types, SORD_OBJECT);
 				if (sord_node_get_type(type) == SORD_URI) {
-					zix_tree_insert(
-						(ZixTree*)this_port->classes,
-						lilv_node_new_from_node(plugin->world, type), NULL);
+					lilv_collection_insert(
+						this_port->classes,
+						lilv_node_new_from_node(plugin->world, type));
 				} else {
 					LILV_WARNF("Plugin <%s> port type is not a URI\n",
 					           lilv_node_as_uri(plugin->plugin_uri));
 				}
 			}
-			sord_iter_free(types);
+			lilv_world_iter_free(plugin->world, types);
 
 			lilv_node_free(symbol);
 			lilv_node_free(index);
 		}
-		sord_iter_free(ports);
+		lilv_world_iter_free(plugin->world, ports);
 
 		// Check sanity
 		for (uint32_t i = 0; i < plugin->num_ports; ++i) {
@@ -358,15 +474,25 @@ lilv_plugin_load_ports_if_necessary(const LilvPlugin* const_plugin)
 				break;
 			}
 		}
+
+		if (plugin->ports) {
+			lilv_plugin_index_ports(plugin);
+		}
 	}
+	lilv_plugin_unlock(plugin);
 }
 
 void
 lilv_plugin_load_if_necessary(const LilvPlugin* plugin)
 {
+	lilv_plugin_lock(plugin);
 	if (!plugin->loaded) {
+		// Loading adds to the shared model, so excludes all other queries
+		lilv_world_write_lock(plugin->world);
 		lilv_plugin_load((LilvPlugin*)plugin);
+		lilv_world_write_unlock(plugin->world);
 	}
+	lilv_plugin_unlock(plugin);
 }
 
 const LilvNode*
@@ -381,10 +507,11 @@ lilv_plugin_get_bundle_uri(const LilvPlugin* plugin)
 	return plugin->bundle_uri;
 }
 
-const LilvNode*
-lilv_plugin_get_library_uri(const LilvPlugin* plugin)
+static void
+lilv_plugin_load_library_uri_if_necessary(LilvPlugin* plugin)
 {
-	lilv_plugin_load_if_necessary((LilvPlugin*)plugin);
+	lilv_plugin_lock(plugin);
+	lilv_plugin_load_if_necessary(plugin);
 	if (!plugin->binary_uri) {
 		// <plugin> lv2:binary ?binary
 		SordIter* i = lilv_world_query_internal(plugin->world,
@@ -394,13 +521,20 @@ lilv_plugin_get_library_uri(const LilvPlugin* plugin)
 		FOREACH_MATCH(i) {
 			const SordNode* binary_node = sord_iter_get_node(i, SORD_OBJECT);
 			if (sord_node_get_type(binary_node) == SORD_URI) {
-				((LilvPlugin*)plugin)->binary_uri =
+				plugin->binary_uri =
 					lilv_node_new_from_node(plugin->world, binary_node);
 				break;
 			}
 		}
-		sord_iter_free(i);
+		lilv_world_iter_free(plugin->world, i);
 	}
+	lilv_plugin_unlock(plugin);
+}
+
+const LilvNode*
+lilv_plugin_get_library_uri(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_library_uri_if_necessary((LilvPlugin*)plugin);
 	if (!plugin->binary_uri) {
 		LILV_WARNF("Plugin <%s> has no lv2:binary\n",
 		           lilv_node_as_uri(lilv_plugin_get_uri(plugin)));
@@ -417,43 +551,111 @@ lilv_plugin_get_data_uris(const LilvPlugin* plugin)
 const LilvPluginClass*
 lilv_plugin_get_class(const LilvPlugin* plugin)
 {
+	lilv_plugin_lock(plugin);
 	lilv_plugin_load_if_necessary((LilvPlugin*)plugin);
 	if (!plugin->plugin_class) {
+		LilvWorld* const world = plugin->world;
+		lilv_world_load_plugin_classes_if_necessary(world);
+
 		// <plugin> a ?class
-		SordIter* c = lilv_world_query_internal(plugin->world,
-		                                        plugin->plugin_uri->node,
-		                                        plugin->world->uris.rdf_a,
-		                                        NULL);
-		FOREACH_MATCH(c) {
-			const SordNode* class_node = sord_iter_get_node(c, SORD_OBJECT);
-			if (sord_node_get_type(class_node) != SORD_URI) {
+		LilvNodes* const types = lilv_world_find_nodes_internal(
+			world, plugin->plugin_uri->node, world->uris.rdf_a, NULL);
+		LILV_FOREACH(nodes, i, types) {
+			const LilvNode* klass = lilv_nodes_get(types, i);
+			if (!lilv_node_is_uri(klass) ||
+			    lilv_node_equals(klass, world->lv2_plugin_class->uri)) {
 				continue;
 			}
 
-			LilvNode* klass = lilv_node_new_from_node(plugin->world, class_node);
-			if (!lilv_node_equals(klass, plugin->world->lv2_plugin_class->uri)) {
-				const LilvPluginClass* pclass = lilv_plugin_classes_get_by_uri(
-					plugin->world->plugin_classes, klass);
+			// Load the specification that defines this class, if necessary
+			lilv_world_load_namespace(world, klass->node);
 
-				if (pclass) {
-					((LilvPlugin*)plugin)->plugin_class = pclass;
-					lilv_node_free(klass);
-					break;
-				}
+			const LilvPluginClass* pclass =
+				lilv_plugin_classes_get_by_uri(world->plugin_classes, klass);
+			if (pclass) {
+				((LilvPlugin*)plugin)->plugin_class = pclass;
+				break;
 			}
-
-			lilv_node_free(klass);
 		}
-		sord_iter_free(c);
+		lilv_nodes_free(types);
 
 		if (plugin->plugin_class == NULL) {
 			((LilvPlugin*)plugin)->plugin_class =
 				plugin->world->lv2_plugin_class;
 		}
 	}
+	lilv_plugin_unlock(plugin);
 	return plugin->plugin_class;
 }
 
+/** Load features, extension data, and latency, which are often checked. */
+void
+lilv_plugin_load_metadata_if_necessary(const LilvPlugin* const_plugin)
+{
+	LilvPlugin* const plugin = (LilvPlugin*)const_plugin;
+	LilvWorld* const  world  = plugin->world;
+
+	lilv_plugin_lock(plugin);
+	if (!plugin->metadata_loaded) {
+		const LilvPortDescriptor* const table =
+			lilv_plugin_get_port_table(plugin);
+
+		plugin->required_features = lilv_world_find_nodes_internal(
+			world, plugin->plugin_uri->node, world->uris.lv2_requiredFeature,
+			NULL);
+		plugin->optional_features = lilv_world_find_nodes_internal(
+			world, plugin->plugin_uri->node, world->uris.lv2_optionalFeature,
+			NULL);
+		plugin->extension_data = lilv_world_find_nodes_internal(
+			world, plugin->plugin_uri->node, world->uris.lv2_extensionData,
+			NULL);
+
+		// Prefer a port with lv2:reportsLatency to an output port designation
+		uint32_t designated = (uint32_t)-1;
+		for (uint32_t i = 0; table && i < plugin->num_ports; ++i) {
+			const bool reports =
+				table[i].properties & LILV_PORT_PROPERTY_REPORTS_LATENCY;
+			const bool is_latency = lilv_world_ask_internal(
+				world, plugin->ports[i]->node->node,
+				world->uris.lv2_designation, world->uris.lv2_latency);
+
+			if (reports && plugin->latency_port == (uint32_t)-1) {
+				plugin->latency_port = i;
+			} else if (is_latency && designated == (uint32_t)-1 &&
+			           table[i].direction == LILV_PORT_DIRECTION_OUTPUT) {
+				designated = i;
+			}
+
+			plugin->has_latency = plugin->has_latency || reports || is_latency;
+		}
+
+		if (plugin->latency_port == (uint32_t)-1) {
+			plugin->latency_port = designated;
+		}
+
+		plugin->metadata_loaded = true;
+	}
+	lilv_plugin_unlock(plugin);
+}
+
+void
+lilv_plugin_load_all(LilvPlugin* plugin)
+{
+	LilvWorld* const world = plugin->world;
+
+	lilv_plugin_load_metadata_if_necessary(plugin);
+	lilv_plugin_load_ports_if_necessary(plugin);
+	lilv_plugin_load_library_uri_if_necessary(plugin);
+	lilv_plugin_get_class(plugin);
+
+	// Load presets and other resources that apply to this plugin
+	LilvNodes* const related = lilv_plugin_get_related(plugin, NULL);
+	LILV_FOREACH(nodes, i, related) {
+		lilv_world_load_resource(world, lilv_nodes_get(related, i));
+	}
+	lilv_nodes_free(related);
+}
+
 static LilvNodes*
 lilv_plugin_get_value_internal(const LilvPlugin* plugin,
                                const SordNode*   predicate)
@@ -500,16 +702,14 @@ lilv_plugin_verify(const LilvPlugin* plugin)
 LilvNode*
 lilv_plugin_get_name(const LilvPlugin* plugin)
 {
-	LilvNodes* results = lilv_plugin_get_value_internal(
-		plugin, plugin->world->uris.doap_name);
-
-	LilvNode* ret = NULL;
-	if (results) {
-		LilvNode* val = lilv_nodes_get_first(results);
-		if (lilv_node_is_string(val)) {
-			ret = lilv_node_duplicate(val);
-		}
-		lilv_nodes_free(results);
+	lilv_plugin_load_if_necessary(plugin);
+
+	LilvNode* ret = lilv_world_get_preferred_value(
+		plugin->world, plugin->plugin_uri->node, plugin->world->uris.doap_name);
+
+	if (ret && !lilv_node_is_string(ret)) {
+		lilv_node_free(ret);
+		ret = NULL;
 	}
 
 	if (!ret) {
@@ -520,6 +720,23 @@ lilv_plugin_get_name(const LilvPlugin* plugin)
 	return ret;
 }
 
+const LilvNode*
+lilv_plugin_borrow_name(const LilvPlugin* plugin)
+{
+	lilv_plugin_load_if_necessary(plugin);
+
+	const LilvNode* ret = lilv_world_borrow_preferred_value(
+		plugin->world, plugin->plugin_uri->node, plugin->world->uris.doap_name);
+
+	if (!ret || !lilv_node_is_string(ret)) {
+		LILV_WARNF("Plugin <%s> has no (mandatory) doap:name\n",
+		           lilv_node_as_string(lilv_plugin_get_uri(plugin)));
+		return NULL;
+	}
+
+	return ret;
+}
+
 LilvNodes*
 lilv_plugin_get_value(const LilvPlugin* plugin,
                       const LilvNode*   predicate)
@@ -528,6 +745,14 @@ lilv_plugin_get_value(const LilvPlugin* plugin,
 	return lilv_world_find_nodes(plugin->world, plugin->plugin_uri, predicate, NULL);
 }
 
+LilvMatches*
+lilv_plugin_get_matches(const LilvPlugin* plugin, const LilvNode* predicate)
+{
+	lilv_plugin_load_if_necessary(plugin);
+	return lilv_world_find_matches(
+		plugin->world, plugin->plugin_uri, predicate, NULL);
+}
+
 uint32_t
 lilv_plugin_get_num_ports(const LilvPlugin* plugin)
 {
@@ -535,50 +760,47 @@ lilv_plugin_get_num_ports(const LilvPlugin* plugin)
 	return plugin->num_ports;
 }
 
+const LilvPortDescriptor*
+lilv_plugin_get_port_table(const LilvPlugin* plugin)
+{
+	lilv_plugin_lock(plugin);
+	lilv_plugin_load_ports_if_necessary(plugin);
+
+	if (!plugin->port_table && plugin->num_ports > 0) {
+		LilvPortDescriptor* const table = (LilvPortDescriptor*)calloc(
+			plugin->num_ports, sizeof(LilvPortDescriptor));
+
+		for (uint32_t i = 0; i < plugin->num_ports; ++i) {
+			lilv_port_get_descriptor(plugin, plugin->ports[i], &table[i]);
+		}
+
+		((LilvPlugin*)plugin)->port_table = table;
+	}
+
+	lilv_plugin_unlock(plugin);
+	return plugin->port_table;
+}
+
 void
 lilv_plugin_get_port_ranges_float(const LilvPlugin* plugin,
                                   float*            min_values,
                                   float*            max_values,
                                   float*            def_values)
 {
-	lilv_plugin_load_ports_if_necessary(plugin);
-	LilvNode*  min    = NULL;
-	LilvNode*  max    = NULL;
-	LilvNode*  def    = NULL;
-	LilvNode** minptr = min_values ? &min : NULL;
-	LilvNode** maxptr = max_values ? &max : NULL;
-	LilvNode** defptr = def_values ? &def : NULL;
-
-	for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-		lilv_port_get_range(plugin, plugin->ports[i], defptr, minptr, maxptr);
+	const LilvPortDescriptor* const table = lilv_plugin_get_port_table(plugin);
 
+	for (uint32_t i = 0; table && i < plugin->num_ports; ++i) {
 		if (min_values) {
-			if (lilv_node_is_float(min) || lilv_node_is_int(min)) {
-				min_values[i] = lilv_node_as_float(min);
-			} else {
-				min_values[i] = NAN;
-			}
+			min_values[i] = table[i].min;
 		}
 
 		if (max_values) {
-			if (lilv_node_is_float(max) || lilv_node_is_int(max)) {
-				max_values[i] = lilv_node_as_float(max);
-			} else {
-				max_values[i] = NAN;
-			}
+			max_values[i] = table[i].max;
 		}
 
 		if (def_values) {
-			if (lilv_node_is_float(def) || lilv_node_is_int(def)) {
-				def_values[i] = lilv_node_as_float(def);
-			} else {
-				def_values[i] = NAN;
-			}
+			def_values[i] = table[i].def;
 		}
-
-		lilv_node_free(def);
-		lilv_node_free(min);
-		lilv_node_free(max);
 	}
 }
 
@@ -638,61 +860,8 @@ lilv_plugin_get_num_ports_of_class(const LilvPlugin* plugin,
 bool
 lilv_plugin_has_latency(const LilvPlugin* plugin)
 {
-	lilv_plugin_load_if_necessary(plugin);
-	SordIter* ports = lilv_world_query_internal(
-		plugin->world,
-		plugin->plugin_uri->node,
-		plugin->world->uris.lv2_port,
-		NULL);
-
-	bool ret = false;
-	FOREACH_MATCH(ports) {
-		const SordNode* port = sord_iter_get_node(ports, SORD_OBJECT);
-		SordIter*       prop = lilv_world_query_internal(
-			plugin->world,
-			port,
-			plugin->world->uris.lv2_portProperty,
-			plugin->world->uris.lv2_reportsLatency);
-		SordIter* des = lilv_world_query_internal(
-			plugin->world,
-			port,
-			plugin->world->uris.lv2_designation,
-			plugin->world->uris.lv2_latency);
-		const bool latent = !sord_iter_end(prop) || !sord_iter_end(des);
-		sord_iter_free(prop);
-		sord_iter_free(des);
-		if (latent) {
-			ret = true;
-			break;
-		}
-	}
-	sord_iter_free(ports);
-
-	return ret;
-}
-
-static const LilvPort*
-lilv_plugin_get_port_by_property(const LilvPlugin* plugin,
-                                 const SordNode*   port_property)
-{
-	lilv_plugin_load_ports_if_necessary(plugin);
-	for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-		LilvPort* port = plugin->ports[i];
-		SordIter* iter = lilv_world_query_internal(
-			plugin->world,
-			port->node->node,
-			plugin->world->uris.lv2_portProperty,
-			port_property);
-
-		const bool found = !sord_iter_end(iter);
-		sord_iter_free(iter);
-
-		if (found) {
-			return port;
-		}
-	}
-
-	return NULL;
+	lilv_plugin_load_metadata_if_necessary(plugin);
+	return plugin->has_latency;
 }
 
 const LilvPort*
@@ -712,7 +881,7 @@ lilv_plugin_get_port_by_designation(const LilvPlugin* plugin,
 
 		const bool found = !sord_iter_end(iter) &&
 			(!port_class || lilv_port_is_a(plugin, port, port_class));
-		sord_iter_free(iter);
+		lilv_world_iter_free(plugin->world, iter);
 
 		if (found) {
 			return port;
@@ -725,44 +894,17 @@ lilv_plugin_get_port_by_designation(const LilvPlugin* plugin,
 uint32_t
 lilv_plugin_get_latency_port_index(const LilvPlugin* plugin)
 {
-	LilvNode* lv2_OutputPort =
-		lilv_new_uri(plugin->world, LV2_CORE__OutputPort);
-	LilvNode* lv2_latency =
-		lilv_new_uri(plugin->world, LV2_CORE__latency);
-
-	const LilvPort* prop_port = lilv_plugin_get_port_by_property(
-		plugin, plugin->world->uris.lv2_reportsLatency);
-	const LilvPort* des_port = lilv_plugin_get_port_by_designation(
-		plugin, lv2_OutputPort, lv2_latency);
-
-	lilv_node_free(lv2_latency);
-	lilv_node_free(lv2_OutputPort);
-
-	if (prop_port) {
-		return prop_port->index;
-	} else if (des_port) {
-		return des_port->index;
-	} else {
-		return (uint32_t)-1;
-	}
+	lilv_plugin_load_metadata_if_necessary(plugin);
+	return plugin->latency_port;
 }
 
 bool
 lilv_plugin_has_feature(const LilvPlugin* plugin,
                         const LilvNode*   feature)
 {
-	lilv_plugin_load_if_necessary(plugin);
-	const SordNode* predicates[] = { plugin->world->uris.lv2_requiredFeature,
-	                                 plugin->world->uris.lv2_optionalFeature,
-	                                 NULL };
-
-	for (const SordNode** pred = predicates; *pred; ++pred) {
-		if (lilv_world_ask_internal(
-			    plugin->world, plugin->plugin_uri->node, *pred, feature->node)) {
-			return true;
-		}
-	}
-	return false;
+	lilv_plugin_load_metadata_if_necessary(plugin);
+	return lilv_nodes_contains(plugin->required_features, feature) ||
+	       lilv_nodes_contains(plugin->optional_features, feature);
 }
 
 LilvNodes*
@@ -806,12 +948,8 @@ lilv_plugin_has_extension_data(const LilvPlugin* plugin,
 		return false;
 	}
 
-	lilv_plugin_load_if_necessary(plugin);
-	return lilv_world_ask_internal(
-		plugin->world,
-		plugin->plugin_uri->node,
-		plugin->world->uris.lv2_extensionData,
-		uri->node);
+	lilv_plugin_load_metadata_if_necessary(plugin);
+	return lilv_nodes_contains(plugin->extension_data, uri);
 }
 
 LilvNodes*
@@ -837,10 +975,15 @@ lilv_plugin_get_port_by_symbol(const LilvPlugin* plugin,
                                const LilvNode*   symbol)
 {
 	lilv_plugin_load_ports_if_necessary(plugin);
-	for (uint32_t i = 0; i < plugin->num_ports; ++i) {
-		LilvPort* port = plugin->ports[i];
-		if (lilv_node_equals(port->symbol, symbol)) {
-			return port;
+	if (!plugin->port_index || !symbol) {
+		return NULL;
+	}
+
+	for (uint32_t s = lilv_plugin_port_slot(plugin, symbol);
+	     plugin->port_index[s];
+	     s = (s + 1u) & plugin->port_index_mask) {
+		if (lilv_node_equals(plugin->port_index[s]->symbol, symbol)) {
+			return plugin->port_index[s];
 		}
 	}
 
@@ -852,24 +995,19 @@ lilv_plugin_get_project(const LilvPlugin* plugin)
 {
 	lilv_plugin_load_if_necessary(plugin);
 
-	SordNode* lv2_project = sord_new_uri(plugin->world->world,
-	                                     (const uint8_t*)LV2_CORE__project);
-
 	SordIter* projects = lilv_world_query_internal(plugin->world,
 	                                               plugin->plugin_uri->node,
-	                                               lv2_project,
+	                                               plugin->world->uris.lv2_project,
 	                                               NULL);
 
-	sord_node_free(plugin->world->world, lv2_project);
-
 	if (sord_iter_end(projects)) {
-		sord_iter_free(projects);
+		lilv_world_iter_free(plugin->world, projects);
 		return NULL;
 	}
 
 	const SordNode* project = sord_iter_get_node(projects, SORD_OBJECT);
 
-	sord_iter_free(projects);
+	lilv_world_iter_free(plugin->world, projects);
 	return lilv_node_new_from_node(plugin->world, project);
 }
 
@@ -878,26 +1016,25 @@ lilv_plugin_get_author(const LilvPlugin* plugin)
 {
 	lilv_plugin_load_if_necessary(plugin);
 
-	SordNode* doap_maintainer = sord_new_uri(
-		plugin->world->world, NS_DOAP "maintainer");
+	LilvWorld* const world           = plugin->world;
+	SordNode* const  doap_maintainer = world->uris.doap_maintainer;
 
 	SordIter* maintainers = lilv_world_query_internal(
-		plugin->world,
+		world,
 		plugin->plugin_uri->node,
 		doap_maintainer,
 		NULL);
 
 	if (sord_iter_end(maintainers)) {
-		sord_iter_free(maintainers);
+		lilv_world_iter_free(world, maintainers);
 
 		LilvNode* project = lilv_plugin_get_project(plugin);
 		if (!project) {
-			sord_node_free(plugin->world->world, doap_maintainer);
 			return NULL;
 		}
 
 		maintainers = lilv_world_query_internal(
-			plugin->world,
+			world,
 			project->node,
 			doap_maintainer,
 			NULL);
@@ -905,29 +1042,24 @@ lilv_plugin_get_author(const LilvPlugin* plugin)
 		lilv_node_free(project);
 	}
 
-	sord_node_free(plugin->world->world, doap_maintainer);
-
 	if (sord_iter_end(maintainers)) {
-		sord_iter_free(maintainers);
+		lilv_world_iter_free(world, maintainers);
 		return NULL;
 	}
 
 	const SordNode* author = sord_iter_get_node(maintainers, SORD_OBJECT);
 
-	sord_iter_free(maintainers);
+	lilv_world_iter_free(world, maintainers);
 	return author;
 }
 
 static LilvNode*
-lilv_plugin_get_author_property(const LilvPlugin* plugin, const uint8_t* uri)
+lilv_plugin_get_author_property(const LilvPlugin* plugin,
+                                const SordNode*   predicate)
 {
 	const SordNode* author = lilv_plugin_get_author(plugin);
 	if (author) {
-		SordWorld* sworld = plugin->world->world;
-		SordNode*  pred   = sord_new_uri(sworld, uri);
-		LilvNode*  ret    = lilv_plugin_get_one(plugin, author, pred);
-		sord_node_free(sworld, pred);
-		return ret;
+		return lilv_plugin_get_one(plugin, author, predicate);
 	}
 	return NULL;
 }
@@ -935,19 +1067,69 @@ lilv_plugin_get_author_property(const LilvPlugin* plugin, const uint8_t* uri)
 LilvNode*
 lilv_plugin_get_author_name(const LilvPlugin* plugin)
 {
-	return lilv_plugin_get_author_property(plugin, NS_FOAF "name");
+	return lilv_plugin_get_author_property(plugin,
+	                                       plugin->world->uris.foaf_name);
 }
 
 LilvNode*
 lilv_plugin_get_author_email(const LilvPlugin* plugin)
 {
-	return lilv_plugin_get_author_property(plugin, NS_FOAF "mbox");
+	return lilv_plugin_get_author_property(plugin,
+	                                       plugin->world->uris.foaf_mbox);
 }
 
 LilvNode*
 lilv_plugin_get_author_homepage(const LilvPlugin* plugin)
 {
-	return lilv_plugin_get_author_property(plugin, NS_FOAF "homepage");
+	return lilv_plugin_get_author_property(plugin,
+	                                       plugin->world->uris.foaf_homepage);
+}
+
+/** Like lilv_plugin_get_author_property(), but remembered by the world. */
+static const LilvNode*
+lilv_plugin_borrow_author_property(const LilvPlugin* plugin,
+                                   const SordNode*   predicate)
+{
+	lilv_plugin_load_if_necessary(plugin);
+
+	LilvWorld* const world  = plugin->world;
+	const SordNode*  plug   = plugin->plugin_uri->node;
+	const LilvNode*  author = lilv_world_borrow_preferred_value(
+		world, plug, world->uris.doap_maintainer);
+
+	if (!author) {
+		const LilvNode* const project = lilv_world_borrow_preferred_value(
+			world, plug, world->uris.lv2_project);
+		if (project) {
+			author = lilv_world_borrow_preferred_value(
+				world, project->node, world->uris.doap_maintainer);
+		}
+	}
+
+	return author ? lilv_world_borrow_preferred_value(
+		                world, author->node, predicate)
+	              : NULL;
+}
+
+const LilvNode*
+lilv_plugin_borrow_author_name(const LilvPlugin* plugin)
+{
+	return lilv_plugin_borrow_author_property(
+		plugin, plugin->world->uris.foaf_name);
+}
+
+const LilvNode*
+lilv_plugin_borrow_author_email(const LilvPlugin* plugin)
+{
+	return lilv_plugin_borrow_author_property(
+		plugin, plugin->world->uris.foaf_mbox);
+}
+
+const LilvNode*
+lilv_plugin_borrow_author_homepage(const LilvPlugin* plugin)
+{
+	return lilv_plugin_borrow_author_property(
+		plugin, plugin->world->uris.foaf_homepage);
 }
 
 bool
@@ -961,10 +1143,8 @@ lilv_plugin_get_uis(const LilvPlugin* plugin)
 {
 	lilv_plugin_load_if_necessary(plugin);
 
-	SordNode* ui_ui_node = sord_new_uri(plugin->world->world,
-	                                    (const uint8_t*)LV2_UI__ui);
-	SordNode* ui_binary_node = sord_new_uri(plugin->world->world,
-	                                        (const uint8_t*)LV2_UI__binary);
+	SordNode* ui_ui_node     = plugin->world->uris.ui_ui;
+	SordNode* ui_binary_node = plugin->world->uris.ui_binary;
 
 	LilvUIs*  result = lilv_uis_new();
 	SordIter* uis    = lilv_world_query_internal(plugin->world,
@@ -996,12 +1176,9 @@ lilv_plugin_get_uis(const LilvPlugin* plugin)
 			type,
 			binary);
 
-		zix_tree_insert((ZixTree*)result, lilv_ui, NULL);
+		lilv_collection_insert(result, lilv_ui);
 	}
-	sord_iter_free(uis);
-
-	sord_node_free(plugin->world->world, ui_binary_node);
-	sord_node_free(plugin->world->world, ui_ui_node);
+	lilv_world_iter_free(plugin->world, uis);
 
 	if (lilv_uis_size(result) > 0) {
 		return result;
@@ -1029,12 +1206,11 @@ lilv_plugin_get_related(const LilvPlugin* plugin, const LilvNode* type)
 
 	LilvNodes* matches = lilv_nodes_new();
 	LILV_FOREACH(nodes, i, related) {
-		LilvNode* node  = (LilvNode*)lilv_collection_get((ZixTree*)related, i);
+		LilvNode* node  = (LilvNode*)lilv_collection_get(related, i);
 		if (lilv_world_ask_internal(
 			    world, node->node, world->uris.rdf_a, type->node)) {
-			zix_tree_insert((ZixTree*)matches,
-			                lilv_node_new_from_node(world, node->node),
-			                NULL);
+			lilv_collection_insert(matches,
+			                       lilv_node_new_from_node(world, node->node));
 		}
 	}
 
@@ -1093,18 +1269,22 @@ lilv_plugin_write_description(LilvWorld*        world,
 	// Write prefixes if this is a new file
 	maybe_write_prefixes(writer, env, plugin_file);
 
-	// Write plugin description
-	SordIter* plug_iter = lilv_world_query_internal(
-		world, subject->node, NULL, NULL);
+	// Write plugin description (sord_write_iter frees the iterators)
+	lilv_world_read_lock(world);
+	lilv_world_lock(world);
+	SordIter* plug_iter = sord_search(
+		world->model, subject->node, NULL, NULL, NULL);
 	sord_write_iter(plug_iter, writer);
 
 	// Write port descriptions
 	for (uint32_t i = 0; i < num_ports; ++i) {
 		const LilvPort* port = plugin->ports[i];
-		SordIter* port_iter = lilv_world_query_internal(
-			world, port->node->node, NULL, NULL);
+		SordIter* port_iter = sord_search(
+			world->model, port->node->node, NULL, NULL, NULL);
 		sord_write_iter(port_iter, writer);
 	}
+	lilv_world_unlock(world);
+	lilv_world_read_unlock(world);
 
 	serd_writer_free(writer);
 	serd_env_free(env);
@@ -18,7 +18,6 @@
 
 #include "lilv/lilv.h"
 #include "sord/sord.h"
-#include "zix/tree.h"
 
 #include <stdbool.h>
 #include <stdlib.h>
@@ -36,6 +35,8 @@ lilv_plugin_class_new(LilvWorld*      world,
 	pc->parent_uri = (parent_node
 	                  ? lilv_node_new_from_node(world, parent_node)
 	                  : NULL);
+	pc->parent     = NULL;
+	pc->children   = lilv_collection_new(lilv_header_compare_by_uri, NULL);
 	return pc;
 }
 
@@ -49,9 +50,39 @@ lilv_plugin_class_free(LilvPluginClass* plugin_class)
 	lilv_node_free(plugin_class->uri);
 	lilv_node_free(plugin_class->parent_uri);
 	lilv_node_free(plugin_class->label);
+	lilv_collection_free(plugin_class->children);
 	free(plugin_class);
 }
 
+void
+lilv_plugin_classes_link(LilvWorld* world)
+{
+	LilvPluginClass* const   root    = world->lv2_plugin_class;
+	LilvPluginClasses* const classes = world->plugin_classes;
+
+	/* Only link classes without a parent, which are new or whose parent was
+	   not loaded before, so existing children collections are never rebuilt
+	   and results of lilv_plugin_class_get_subclasses() stay valid. */
+	LILV_FOREACH(plugin_classes, i, classes) {
+		LilvPluginClass* const c =
+			(LilvPluginClass*)lilv_plugin_classes_get(classes, i);
+		if (c->parent) {
+			continue;
+		}
+
+		LilvPluginClass* const parent =
+			lilv_node_equals(c->parent_uri, root->uri)
+				? root
+				: (LilvPluginClass*)lilv_plugin_classes_get_by_uri(
+					classes, c->parent_uri);
+
+		c->parent = parent;
+		if (parent) {
+			lilv_collection_insert(parent->children, c);
+		}
+	}
+}
+
 const LilvNode*
 lilv_plugin_class_get_parent_uri(const LilvPluginClass* plugin_class)
 {
@@ -70,23 +101,56 @@ lilv_plugin_class_get_label(const LilvPluginClass* plugin_class)
 	return plugin_class->label;
 }
 
+const LilvPluginClass*
+lilv_plugin_class_get_parent(const LilvPluginClass* plugin_class)
+{
+	lilv_world_load_plugin_classes_if_necessary(plugin_class->world);
+	return plugin_class->parent;
+}
+
+const LilvPluginClasses*
+lilv_plugin_class_get_subclasses(const LilvPluginClass* plugin_class)
+{
+	lilv_world_load_plugin_classes_if_necessary(plugin_class->world);
+	return plugin_class->children;
+}
+
 LilvPluginClasses*
 lilv_plugin_class_get_children(const LilvPluginClass* plugin_class)
 {
+	const LilvPluginClasses* children =
+		lilv_plugin_class_get_subclasses(plugin_class);
+
 	// Returned list doesn't own categories
-	LilvPluginClasses* all    = plugin_class->world->plugin_classes;
-	LilvPluginClasses* result = zix_tree_new(false, lilv_ptr_cmp, NULL, NULL);
-
-	for (ZixTreeIter* i = zix_tree_begin((ZixTree*)all);
-	     i != zix_tree_end((ZixTree*)all);
-	     i = zix_tree_iter_next(i)) {
-		const LilvPluginClass* c      = (LilvPluginClass*)zix_tree_get(i);
-		const LilvNode*        parent = lilv_plugin_class_get_parent_uri(c);
-		if (parent && lilv_node_equals(lilv_plugin_class_get_uri(plugin_class),
-		                               parent)) {
-			zix_tree_insert((ZixTree*)result, (LilvPluginClass*)c, NULL);
-		}
+	LilvPluginClasses* result =
+		lilv_collection_new(lilv_header_compare_by_uri, NULL);
+
+	LILV_FOREACH(plugin_classes, i, children) {
+		lilv_collection_insert(
+			result, (LilvPluginClass*)lilv_plugin_classes_get(children, i));
 	}
 
 	return result;
 }
+
+bool
+lilv_plugin_class_is_a(const LilvPluginClass* plugin_class,
+                       const LilvPluginClass* ancestor)
+{
+	LilvWorld* const world = plugin_class->world;
+	lilv_world_load_plugin_classes_if_necessary(world);
+
+	// Limit depth in case the class data has cycles
+	const unsigned max_depth =
+		lilv_plugin_classes_size(world->plugin_classes) + 1;
+
+	unsigned depth = 0;
+	for (const LilvPluginClass* c = plugin_class; c && depth <= max_depth;
+	     c = c->parent, ++depth) {
+		if (c == ancestor) {
+			return true;
+		}
+	}
+
+	return false;
+}
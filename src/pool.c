@@ -0,0 +1,149 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#include "lilv_internal.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+/*
+  A pool allocates objects of one size from slabs, which are only freed
+  with the pool.  Released objects are kept in a free list, linked through
+  their first bytes, and reused before any new object is taken from a slab.
+*/
+
+/** Number of objects in the first slab. */
+#define LILV_POOL_FIRST_SLAB 64u
+
+/** Maximum number of objects in a slab, each twice as large as the last. */
+#define LILV_POOL_MAX_SLAB 4096u
+
+/** Header of a slab, followed by its objects, with maximal alignment. */
+typedef union LilvSlabImpl {
+	union LilvSlabImpl* next;  ///< Previously allocated slab
+	double              d;
+	long long           ll;
+	void*               p;
+} LilvSlab;
+
+struct LilvPoolImpl {
+	size_t    size;       ///< Size of an object in bytes
+	unsigned  slab_size;  ///< Number of objects in the next slab
+	LilvSlab* slabs;      ///< All slabs, most recent first
+	void*     free_list;  ///< Released objects
+	char*     next;       ///< First unused object in the most recent slab
+	char*     end;        ///< End of the most recent slab
+#ifdef HAVE_PTHREAD
+	pthread_mutex_t mutex;  ///< Guards everything above
+#endif
+};
+
+LilvPool*
+lilv_pool_new(size_t size)
+{
+	LilvPool* pool = (LilvPool*)calloc(1, sizeof(LilvPool));
+
+	// Round up so that every object is aligned like a slab header
+	pool->size      = (size + sizeof(LilvSlab) - 1) / sizeof(LilvSlab) *
+	                  sizeof(LilvSlab);
+	pool->slab_size = LILV_POOL_FIRST_SLAB;
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_init(&pool->mutex, NULL);
+#endif
+
+	return pool;
+}
+
+void
+lilv_pool_free(LilvPool* pool)
+{
+	if (!pool) {
+		return;
+	}
+
+	for (LilvSlab* s = pool->slabs; s;) {
+		LilvSlab* const next = s->next;
+		free(s);
+		s = next;
+	}
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_destroy(&pool->mutex);
+#endif
+
+	free(pool);
+}
+
+void*
+lilv_pool_alloc(LilvPool* pool)
+{
+	void* obj = NULL;
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_lock(&pool->mutex);
+#endif
+
+	if (pool->free_list) {
+		obj             = pool->free_list;
+		pool->free_list = *(void**)obj;
+	} else {
+		if (pool->next == pool->end) {
+			LilvSlab* const slab = (LilvSlab*)malloc(
+				sizeof(LilvSlab) + pool->slab_size * pool->size);
+			if (slab) {
+				slab->next  = pool->slabs;
+				pool->slabs = slab;
+				pool->next  = (char*)(slab + 1);
+				pool->end   = pool->next + pool->slab_size * pool->size;
+				if (pool->slab_size < LILV_POOL_MAX_SLAB) {
+					pool->slab_size *= 2u;
+				}
+			}
+		}
+
+		if (pool->next != pool->end) {
+			obj = pool->next;
+			pool->next += pool->size;
+		}
+	}
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_unlock(&pool->mutex);
+#endif
+
+	return obj;
+}
+
+void
+lilv_pool_release(LilvPool* pool, void* obj)
+{
+	if (!obj) {
+		return;
+	}
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_lock(&pool->mutex);
+#endif
+
+	*(void**)obj    = pool->free_list;
+	pool->free_list = obj;
+
+#ifdef HAVE_PTHREAD
+	pthread_mutex_unlock(&pool->mutex);
+#endif
+}
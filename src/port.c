@@ -19,16 +19,63 @@
 #include "lv2/atom/atom.h"
 #include "lv2/core/lv2.h"
 #include "lv2/event/event.h"
+#include "lv2/port-props/port-props.h"
 
 #include "lilv/lilv.h"
 #include "sord/sord.h"
-#include "zix/tree.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+/** A URI that corresponds to a flag in a LilvPortDescriptor. */
+typedef struct {
+	const char* uri;
+	uint32_t    flag;
+} LilvPortFlag;
+
+static const LilvPortFlag port_types[] = {
+	{ LV2_CORE__AudioPort, LILV_PORT_TYPE_AUDIO },
+	{ LV2_CORE__ControlPort, LILV_PORT_TYPE_CONTROL },
+	{ LV2_CORE__CVPort, LILV_PORT_TYPE_CV },
+	{ LV2_ATOM__AtomPort, LILV_PORT_TYPE_ATOM },
+	{ LV2_EVENT__EventPort, LILV_PORT_TYPE_EVENT },
+	{ NULL, 0 }
+};
+
+static const LilvPortFlag port_properties[] = {
+	{ LV2_CORE__connectionOptional, LILV_PORT_PROPERTY_CONNECTION_OPTIONAL },
+	{ LV2_CORE__enumeration, LILV_PORT_PROPERTY_ENUMERATION },
+	{ LV2_CORE__integer, LILV_PORT_PROPERTY_INTEGER },
+	{ LV2_CORE__isSideChain, LILV_PORT_PROPERTY_IS_SIDE_CHAIN },
+	{ LV2_CORE__reportsLatency, LILV_PORT_PROPERTY_REPORTS_LATENCY },
+	{ LV2_CORE__sampleRate, LILV_PORT_PROPERTY_SAMPLE_RATE },
+	{ LV2_CORE__toggled, LILV_PORT_PROPERTY_TOGGLED },
+	{ LV2_PORT_PROPS__causesArtifacts, LILV_PORT_PROPERTY_CAUSES_ARTIFACTS },
+	{ LV2_PORT_PROPS__expensive, LILV_PORT_PROPERTY_EXPENSIVE },
+	{ LV2_PORT_PROPS__hasStrictBounds, LILV_PORT_PROPERTY_HAS_STRICT_BOUNDS },
+	{ LV2_PORT_PROPS__logarithmic, LILV_PORT_PROPERTY_LOGARITHMIC },
+	{ LV2_PORT_PROPS__notAutomatic, LILV_PORT_PROPERTY_NOT_AUTOMATIC },
+	{ LV2_PORT_PROPS__notOnGUI, LILV_PORT_PROPERTY_NOT_ON_GUI },
+	{ LV2_PORT_PROPS__trigger, LILV_PORT_PROPERTY_TRIGGER },
+	{ NULL, 0 }
+};
+
+static uint32_t
+lilv_port_flag(const LilvPortFlag* flags, const char* uri)
+{
+	for (const LilvPortFlag* f = flags; f->uri; ++f) {
+		if (!strcmp(f->uri, uri)) {
+			return f->flag;
+		}
+	}
+
+	return 0;
+}
 
 LilvPort*
 lilv_port_new(LilvWorld*      world,
@@ -36,7 +83,7 @@ lilv_port_new(LilvWorld*      world,
               uint32_t        index,
               const char*     symbol)
 {
-	LilvPort* port = (LilvPort*)malloc(sizeof(LilvPort));
+	LilvPort* port = (LilvPort*)lilv_pool_alloc(world->port_pool);
 	port->node    = lilv_node_new_from_node(world, node);
 	port->index   = index;
 	port->symbol  = lilv_node_new(world, LILV_VALUE_STRING, symbol);
@@ -51,10 +98,67 @@ lilv_port_free(const LilvPlugin* plugin, LilvPort* port)
 		lilv_node_free(port->node);
 		lilv_nodes_free(port->classes);
 		lilv_node_free(port->symbol);
-		free(port);
+		lilv_pool_release(plugin->world->port_pool, port);
 	}
 }
 
+/** Return the value of a numeric range node, or NAN. */
+static float
+lilv_port_range_value(const LilvNode* value)
+{
+	return (lilv_node_is_float(value) || lilv_node_is_int(value))
+		? lilv_node_as_float(value)
+		: NAN;
+}
+
+void
+lilv_port_get_descriptor(const LilvPlugin*   plugin,
+                         const LilvPort*     port,
+                         LilvPortDescriptor* desc)
+{
+	desc->index      = port->index;
+	desc->symbol     = lilv_node_as_string(port->symbol);
+	desc->direction  = LILV_PORT_DIRECTION_UNKNOWN;
+	desc->types      = 0;
+	desc->properties = 0;
+
+	LILV_FOREACH(nodes, i, port->classes) {
+		const char* const uri =
+			lilv_node_as_uri(lilv_nodes_get(port->classes, i));
+
+		if (!strcmp(uri, LV2_CORE__InputPort)) {
+			desc->direction = LILV_PORT_DIRECTION_INPUT;
+		} else if (!strcmp(uri, LV2_CORE__OutputPort)) {
+			desc->direction = LILV_PORT_DIRECTION_OUTPUT;
+		} else {
+			desc->types |= lilv_port_flag(port_types, uri);
+		}
+	}
+
+	SordIter* props = lilv_world_query_internal(
+		plugin->world, port->node->node, plugin->world->uris.lv2_portProperty,
+		NULL);
+	FOREACH_MATCH(props) {
+		const SordNode* prop = sord_iter_get_node(props, SORD_OBJECT);
+		if (sord_node_get_type(prop) == SORD_URI) {
+			desc->properties |= lilv_port_flag(
+				port_properties, (const char*)sord_node_get_string(prop));
+		}
+	}
+	lilv_world_iter_free(plugin->world, props);
+
+	LilvNode* def = NULL;
+	LilvNode* min = NULL;
+	LilvNode* max = NULL;
+	lilv_port_get_range(plugin, port, &def, &min, &max);
+	desc->min = lilv_port_range_value(min);
+	desc->max = lilv_port_range_value(max);
+	desc->def = lilv_port_range_value(def);
+	lilv_node_free(max);
+	lilv_node_free(min);
+	lilv_node_free(def);
+}
+
 bool
 lilv_port_is_a(const LilvPlugin* plugin,
                const LilvPort*   port,
@@ -85,14 +189,14 @@ lilv_port_supports_event(const LilvPlugin* plugin,
                          const LilvPort*   port,
                          const LilvNode*   event_type)
 {
-	const uint8_t* predicates[] = { (const uint8_t*)LV2_EVENT__supportsEvent,
-	                                (const uint8_t*)LV2_ATOM__supports,
-	                                NULL };
+	const SordNode* predicates[] = { plugin->world->uris.ev_supportsEvent,
+	                                 plugin->world->uris.atom_supports,
+	                                 NULL };
 
-	for (const uint8_t** pred = predicates; *pred; ++pred) {
+	for (const SordNode** pred = predicates; *pred; ++pred) {
 		if (lilv_world_ask_internal(plugin->world,
 		                            port->node->node,
-		                            sord_new_uri(plugin->world->world, *pred),
+		                            *pred,
 		                            event_type->node)) {
 			return true;
 		}
@@ -132,6 +236,15 @@ lilv_port_get_value(const LilvPlugin* plugin,
 	return lilv_port_get_value_by_node(plugin, port, predicate->node);
 }
 
+LilvMatches*
+lilv_port_get_matches(const LilvPlugin* plugin,
+                      const LilvPort*   port,
+                      const LilvNode*   predicate)
+{
+	return lilv_world_find_matches(
+		plugin->world, port->node, predicate, NULL);
+}
+
 LilvNode*
 lilv_port_get(const LilvPlugin* plugin,
               const LilvPort*   port,
@@ -164,16 +277,12 @@ LilvNode*
 lilv_port_get_name(const LilvPlugin* plugin,
                    const LilvPort*   port)
 {
-	LilvNodes* results = lilv_port_get_value_by_node(
-		plugin, port, plugin->world->uris.lv2_name);
-
-	LilvNode* ret = NULL;
-	if (results) {
-		LilvNode* val = lilv_nodes_get_first(results);
-		if (lilv_node_is_string(val)) {
-			ret = lilv_node_duplicate(val);
-		}
-		lilv_nodes_free(results);
+	LilvNode* ret = lilv_world_get_preferred_value(
+		plugin->world, port->node->node, plugin->world->uris.lv2_name);
+
+	if (ret && !lilv_node_is_string(ret)) {
+		lilv_node_free(ret);
+		ret = NULL;
 	}
 
 	if (!ret) {
@@ -184,6 +293,22 @@ lilv_port_get_name(const LilvPlugin* plugin,
 	return ret;
 }
 
+const LilvNode*
+lilv_port_borrow_name(const LilvPlugin* plugin,
+                      const LilvPort*   port)
+{
+	const LilvNode* ret = lilv_world_borrow_preferred_value(
+		plugin->world, port->node->node, plugin->world->uris.lv2_name);
+
+	if (!ret || !lilv_node_is_string(ret)) {
+		LILV_WARNF("Plugin <%s> port has no (mandatory) doap:name\n",
+		           lilv_node_as_string(lilv_plugin_get_uri(plugin)));
+		return NULL;
+	}
+
+	return ret;
+}
+
 const LilvNodes*
 lilv_port_get_classes(const LilvPlugin* plugin,
                       const LilvPort*   port)
@@ -231,7 +356,7 @@ lilv_port_get_scale_points(const LilvPlugin* plugin,
 	SordIter* points = lilv_world_query_internal(
 		plugin->world,
 		port->node->node,
-		sord_new_uri(plugin->world->world, (const uint8_t*)LV2_CORE__scalePoint),
+		plugin->world->uris.lv2_scalePoint,
 		NULL);
 
 	LilvScalePoints* ret = NULL;
@@ -251,11 +376,10 @@ lilv_port_get_scale_points(const LilvPlugin* plugin,
 		                                         plugin->world->uris.rdfs_label);
 
 		if (value && label) {
-			zix_tree_insert(
-				(ZixTree*)ret, lilv_scale_point_new(value, label), NULL);
+			lilv_collection_insert(ret, lilv_scale_point_new(value, label));
 		}
 	}
-	sord_iter_free(points);
+	lilv_world_iter_free(plugin->world, points);
 
 	assert(!ret || lilv_nodes_size(ret) > 0);
 	return ret;
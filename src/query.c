@@ -20,6 +20,7 @@
 #include "sord/sord.h"
 #include "zix/tree.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -29,21 +30,21 @@ typedef enum {
 	LILV_LANG_MATCH_EXACT     ///< Exact (language and country) match
 } LilvLangMatch;
 
+/**
+   Return how well the language tag `a` matches the language `b`.
+
+   The length of the language part of `b` (before any dash) is given as
+   `b_lang_len`, since `b` is the same for every value in a query.
+*/
 static LilvLangMatch
-lilv_lang_matches(const char* a, const char* b)
+lilv_lang_matches(const char* a, const char* b, size_t b_lang_len)
 {
 	if (!a || !b) {
 		return LILV_LANG_MATCH_NONE;
 	} else if (!strcmp(a, b)) {
 		return LILV_LANG_MATCH_EXACT;
-	}
-
-	const char*  a_dash     = strchr(a, '-');
-	const size_t a_lang_len = a_dash ? (size_t)(a_dash - a) : strlen(a);
-	const char*  b_dash     = strchr(b, '-');
-	const size_t b_lang_len = b_dash ? (size_t)(b_dash - b) : strlen(b);
-
-	if (a_lang_len == b_lang_len && !strncmp(a, b, a_lang_len)) {
+	} else if (!strncmp(a, b, b_lang_len) &&
+	           (a[b_lang_len] == '\0' || a[b_lang_len] == '-')) {
 		return LILV_LANG_MATCH_PARTIAL;
 	}
 
@@ -58,7 +59,8 @@ lilv_nodes_from_stream_objects_i18n(LilvWorld*    world,
 	LilvNodes*      values  = lilv_nodes_new();
 	const SordNode* nolang  = NULL;  // Untranslated value
 	const SordNode* partial = NULL;  // Partial language match
-	char*           syslang = lilv_get_lang();
+	size_t          len     = 0;
+	const char*     syslang = lilv_world_get_lang(world, &len);
 	FOREACH_MATCH(stream) {
 		const SordNode* value = sord_iter_get_node(stream, field);
 		if (sord_node_get_type(value) == SORD_LITERAL) {
@@ -67,12 +69,11 @@ lilv_nodes_from_stream_objects_i18n(LilvWorld*    world,
 			if (!lang) {
 				nolang = value;
 			} else {
-				switch (lilv_lang_matches(lang, syslang)) {
+				switch (lilv_lang_matches(lang, syslang, len)) {
 				case LILV_LANG_MATCH_EXACT:
 					// Exact language match, add to results
-					zix_tree_insert((ZixTree*)values,
-					                lilv_node_new_from_node(world, value),
-					                NULL);
+					lilv_collection_insert(
+						values, lilv_node_new_from_node(world, value));
 					break;
 				case LILV_LANG_MATCH_PARTIAL:
 					// Partial language match, save in case we find no exact
@@ -83,13 +84,11 @@ lilv_nodes_from_stream_objects_i18n(LilvWorld*    world,
 				}
 			}
 		} else {
-			zix_tree_insert((ZixTree*)values,
-			                lilv_node_new_from_node(world, value),
-			                NULL);
+			lilv_collection_insert(values,
+			                       lilv_node_new_from_node(world, value));
 		}
 	}
-	sord_iter_free(stream);
-	free(syslang);
+	lilv_world_iter_free(world, stream);
 
 	if (lilv_nodes_size(values) > 0) {
 		return values;
@@ -106,8 +105,7 @@ lilv_nodes_from_stream_objects_i18n(LilvWorld*    world,
 	}
 
 	if (best) {
-		zix_tree_insert(
-			(ZixTree*)values, lilv_node_new_from_node(world, best), NULL);
+		lilv_collection_insert(values, lilv_node_new_from_node(world, best));
 	} else {
 		// No matches whatsoever
 		lilv_nodes_free(values);
@@ -123,7 +121,7 @@ lilv_nodes_from_stream_objects(LilvWorld*    world,
                                SordQuadIndex field)
 {
 	if (sord_iter_end(stream)) {
-		sord_iter_free(stream);
+		lilv_world_iter_free(world, stream);
 		return NULL;
 	} else if (world->opt.filter_language) {
 		return lilv_nodes_from_stream_objects_i18n(world, stream, field);
@@ -133,10 +131,615 @@ lilv_nodes_from_stream_objects(LilvWorld*    world,
 			const SordNode* value = sord_iter_get_node(stream, field);
 			LilvNode*       node  = lilv_node_new_from_node(world, value);
 			if (node) {
-				zix_tree_insert((ZixTree*)values, node, NULL);
+				lilv_collection_insert(values, node);
 			}
 		}
-		sord_iter_free(stream);
+		lilv_world_iter_free(world, stream);
 		return values;
 	}
 }
+
+/**
+   A stream of query results, which reads the model directly.
+
+   The stream holds the world read lock until it is freed.  If the thread
+   that made it takes the write lock, for example to load plugin data while
+   stepping through the results, the stream is suspended first: its iterator
+   is freed, and the current statement is remembered so that the search can
+   continue from there afterwards.
+*/
+struct LilvMatchesImpl {
+	LilvWorld*    world;
+	SordIter*     stream;      ///< Stream over the model, or NULL if stopped
+	SordNode*     pattern[3];  ///< Subject, predicate, and object searched
+	SordNode*     position[4]; ///< Current statement while suspended
+	SordQuadIndex field;       ///< Field of each statement to yield
+	LilvNode      view;        ///< Borrowed view of the current node
+	LilvMatches*  next;        ///< Next open stream of the same thread
+};
+
+/** Advance `matches` to the first node that can be viewed, if necessary. */
+static void
+lilv_matches_settle(LilvMatches* matches)
+{
+	LilvWorld* const world = matches->world;
+	for (; !sord_iter_end(matches->stream); sord_iter_next(matches->stream)) {
+		const SordNode* node =
+			sord_iter_get_node(matches->stream, matches->field);
+		if (lilv_node_set_view(&matches->view, world, node)) {
+			break;
+		}
+	}
+}
+
+/** Search again after a suspension.  The world mutex must be held. */
+static void
+lilv_matches_resume(LilvMatches* matches)
+{
+	LilvWorld* const world = matches->world;
+	if (matches->stream || !matches->position[SORD_SUBJECT]) {
+		return;  // Not suspended
+	}
+
+	matches->stream = sord_search(world->model,
+	                              matches->pattern[0],
+	                              matches->pattern[1],
+	                              matches->pattern[2],
+	                              NULL);
+	++world->stats.n_searches;
+
+	// Skip to the current statement, which was referenced so it still exists
+	SordQuad quad;
+	for (; !sord_iter_end(matches->stream); sord_iter_next(matches->stream)) {
+		sord_iter_get(matches->stream, quad);
+		if (quad[0] == matches->position[0] &&
+		    quad[1] == matches->position[1] &&
+		    quad[2] == matches->position[2] &&
+		    quad[3] == matches->position[3]) {
+			break;
+		}
+	}
+
+	for (unsigned i = 0u; i < 4u; ++i) {
+		sord_node_free(world->world, matches->position[i]);
+		matches->position[i] = NULL;
+	}
+}
+
+#ifdef HAVE_PTHREAD
+/** Add `matches` to the open streams of the calling thread. */
+static void
+lilv_matches_open(LilvMatches* matches)
+{
+	LilvWorld* const world = matches->world;
+
+	matches->next = (LilvMatches*)pthread_getspecific(world->streams);
+	pthread_setspecific(world->streams, matches);
+}
+
+/** Remove `matches` from the open streams of the calling thread. */
+static void
+lilv_matches_close(LilvMatches* matches)
+{
+	LilvWorld* const world = matches->world;
+	LilvMatches*     head  = (LilvMatches*)pthread_getspecific(world->streams);
+
+	if (head == matches) {
+		pthread_setspecific(world->streams, matches->next);
+		return;
+	}
+
+	for (LilvMatches* m = head; m; m = m->next) {
+		if (m->next == matches) {
+			m->next = matches->next;
+			break;
+		}
+	}
+}
+#endif
+
+void
+lilv_world_suspend_streams(LilvWorld* world)
+{
+#ifdef HAVE_PTHREAD
+	lilv_world_lock(world);
+	for (LilvMatches* m = (LilvMatches*)pthread_getspecific(world->streams);
+	     m;
+	     m = m->next) {
+		if (m->stream) {
+			if (!sord_iter_end(m->stream)) {
+				SordQuad quad;
+				sord_iter_get(m->stream, quad);
+				for (unsigned i = 0u; i < 4u; ++i) {
+					m->position[i] = quad[i] ? sord_node_copy(quad[i]) : NULL;
+				}
+			}
+
+			sord_iter_free(m->stream);
+			m->stream = NULL;
+		}
+	}
+	lilv_world_unlock(world);
+#endif
+}
+
+LilvMatches*
+lilv_matches_new(LilvWorld*      world,
+                 const SordNode* subject,
+                 const SordNode* predicate,
+                 const SordNode* object,
+                 SordQuadIndex   field)
+{
+	SordIter* const stream =
+		lilv_world_query_internal(world, subject, predicate, object);
+	if (!stream) {
+		lilv_world_iter_free(world, stream);
+		return NULL;
+	}
+
+	LilvMatches* matches = (LilvMatches*)calloc(1, sizeof(LilvMatches));
+	matches->world       = world;
+	matches->stream      = stream;
+	matches->field       = field;
+
+	lilv_world_lock(world);
+	matches->pattern[0] = subject ? sord_node_copy(subject) : NULL;
+	matches->pattern[1] = predicate ? sord_node_copy(predicate) : NULL;
+	matches->pattern[2] = object ? sord_node_copy(object) : NULL;
+	lilv_matches_settle(matches);
+	lilv_world_unlock(world);
+
+#ifdef HAVE_PTHREAD
+	if (!world->frozen) {
+		lilv_matches_open(matches);
+	}
+#endif
+
+	return matches;
+}
+
+void
+lilv_matches_free(LilvMatches* matches)
+{
+	if (matches) {
+		LilvWorld* const world = matches->world;
+
+#ifdef HAVE_PTHREAD
+		if (!world->frozen) {
+			lilv_matches_close(matches);
+		}
+#endif
+
+		lilv_world_lock(world);
+		for (unsigned i = 0u; i < 4u; ++i) {
+			sord_node_free(world->world, matches->position[i]);
+		}
+		for (unsigned i = 0u; i < 3u; ++i) {
+			sord_node_free(world->world, matches->pattern[i]);
+		}
+		lilv_world_unlock(world);
+
+		lilv_world_iter_free(world, matches->stream);
+		free(matches);
+	}
+}
+
+bool
+lilv_matches_is_end(const LilvMatches* matches)
+{
+	if (!matches) {
+		return true;
+	}
+
+	return matches->stream ? sord_iter_end(matches->stream)
+	                       : !matches->position[SORD_SUBJECT];
+}
+
+const LilvNode*
+lilv_matches_get(const LilvMatches* matches)
+{
+	return lilv_matches_is_end(matches) ? NULL : &matches->view;
+}
+
+void
+lilv_matches_next(LilvMatches* matches)
+{
+	if (!lilv_matches_is_end(matches)) {
+		lilv_world_lock(matches->world);
+		lilv_matches_resume(matches);
+		if (!sord_iter_end(matches->stream)) {
+			sord_iter_next(matches->stream);
+		}
+		lilv_matches_settle(matches);
+		lilv_world_unlock(matches->world);
+	}
+}
+
+unsigned
+lilv_matches_count(LilvMatches* matches)
+{
+	if (lilv_matches_is_end(matches)) {
+		return 0u;
+	}
+
+	// Count statements without viewing nodes, so nothing is decoded
+	unsigned n = 0u;
+	lilv_world_lock(matches->world);
+	lilv_matches_resume(matches);
+	for (; !sord_iter_end(matches->stream); sord_iter_next(matches->stream)) {
+		++n;
+	}
+	lilv_world_unlock(matches->world);
+
+	return n;
+}
+
+/** A remembered value of some predicate on some subject. */
+typedef struct {
+	SordNode* subject;    ///< Subject
+	SordNode* predicate;  ///< Predicate
+	LilvNode* value;      ///< First value, or NULL if there is none
+} LilvLabel;
+
+static int
+lilv_label_cmp(const void* a, const void* b, void* user_data)
+{
+	const LilvLabel* const la = (const LilvLabel*)a;
+	const LilvLabel* const lb = (const LilvLabel*)b;
+
+	if (la->subject != lb->subject) {
+		return ((uintptr_t)la->subject < (uintptr_t)lb->subject) ? -1 : 1;
+	} else if (la->predicate != lb->predicate) {
+		return ((uintptr_t)la->predicate < (uintptr_t)lb->predicate) ? -1 : 1;
+	}
+
+	return 0;
+}
+
+void
+lilv_world_clear_label_cache(LilvWorld* world)
+{
+	if (!world->label_cache) {
+		return;
+	}
+
+	lilv_world_lock(world);
+	for (ZixTreeIter* i = zix_tree_begin(world->label_cache);
+	     !zix_tree_iter_is_end(i);
+	     i = zix_tree_iter_next(i)) {
+		LilvLabel* const label = (LilvLabel*)zix_tree_get(i);
+		lilv_node_free(label->value);
+		sord_node_free(world->world, label->predicate);
+		sord_node_free(world->world, label->subject);
+		free(label);
+	}
+
+	zix_tree_free(world->label_cache);
+	world->label_cache = NULL;
+	lilv_world_unlock(world);
+}
+
+/**
+   Return the remembered value of `predicate` on `subject`, querying if needed.
+
+   This must be called with a read lock and the world mutex held.  The mutex
+   is released while querying, but held again when this returns.
+*/
+static const LilvNode*
+lilv_world_remember_value(LilvWorld*      world,
+                          const SordNode* subject,
+                          const SordNode* predicate)
+{
+	LilvLabel    key  = {(SordNode*)subject, (SordNode*)predicate, NULL};
+	ZixTreeIter* iter = NULL;
+
+	if (world->label_generation != world->generation) {
+		lilv_world_clear_label_cache(world);
+	}
+
+	if (world->label_cache &&
+	    !zix_tree_find(world->label_cache, &key, &iter)) {
+		return ((const LilvLabel*)zix_tree_get(iter))->value;
+	}
+
+	// Not remembered, so query and remember the result
+	lilv_world_unlock(world);
+	LilvNodes* const values =
+		lilv_world_find_nodes_internal(world, subject, predicate, NULL);
+	lilv_world_lock(world);
+
+	if (world->label_generation != world->generation) {
+		// A bundle or the language changed while querying, forget everything
+		lilv_world_clear_label_cache(world);
+	}
+
+	if (!world->label_cache) {
+		world->label_cache = zix_tree_new(false, lilv_label_cmp, NULL, NULL);
+		world->label_generation = world->generation;
+	}
+
+	const LilvNode* result = NULL;
+	if (zix_tree_find(world->label_cache, &key, &iter)) {
+		LilvLabel* const label = (LilvLabel*)malloc(sizeof(LilvLabel));
+		label->subject         = sord_node_copy(subject);
+		label->predicate       = sord_node_copy(predicate);
+		label->value = lilv_node_duplicate(lilv_nodes_get_first(values));
+		zix_tree_insert(world->label_cache, label, NULL);
+		result = label->value;
+	} else {
+		// Remembered by another thread while querying
+		result = ((const LilvLabel*)zix_tree_get(iter))->value;
+	}
+
+	lilv_nodes_free(values);
+	return result;
+}
+
+const LilvNode*
+lilv_world_borrow_preferred_value(LilvWorld*      world,
+                                  const SordNode* subject,
+                                  const SordNode* predicate)
+{
+	// Hold a read lock so that the world can not change until this returns
+	lilv_world_read_lock(world);
+
+	lilv_world_lock(world);
+	const LilvNode* const result =
+		lilv_world_remember_value(world, subject, predicate);
+	lilv_world_unlock(world);
+
+	lilv_world_read_unlock(world);
+	return result;
+}
+
+LilvNode*
+lilv_world_get_preferred_value(LilvWorld*      world,
+                               const SordNode* subject,
+                               const SordNode* predicate)
+{
+	lilv_world_read_lock(world);
+
+	// Copy with the mutex held, so the value can not be forgotten meanwhile
+	lilv_world_lock(world);
+	LilvNode* const result = lilv_node_duplicate(
+		lilv_world_remember_value(world, subject, predicate));
+	lilv_world_unlock(world);
+
+	lilv_world_read_unlock(world);
+	return result;
+}
+
+/** The kind of query a cache entry is the result of. */
+typedef enum {
+	LILV_QUERY_NONE,  ///< Empty entry
+	LILV_QUERY_FIND,  ///< Result of lilv_world_find_nodes()
+	LILV_QUERY_ASK    ///< Result of lilv_world_ask()
+} LilvQueryKind;
+
+/** A remembered query result. */
+typedef struct {
+	LilvQueryKind kind;       ///< Kind of query
+	SordNode*     subject;    ///< Subject, or NULL
+	SordNode*     predicate;  ///< Predicate, or NULL
+	SordNode*     object;     ///< Object, or NULL
+	LilvNodes*    values;     ///< Values found, or NULL
+	bool          answer;     ///< Whether a statement was found
+} LilvQueryEntry;
+
+/**
+   A bounded cache of query results.
+
+   Each pattern has exactly one slot, and a new result replaces whatever was
+   there, so the cache never grows beyond the size it was created with.
+*/
+struct LilvQueryCacheImpl {
+	LilvQueryEntry* entries;     ///< Entries, indexed by pattern hash
+	uint32_t        mask;        ///< Number of entries minus one
+	uint64_t        generation;  ///< World query generation of entries
+};
+
+LilvQueryCache*
+lilv_query_cache_new(unsigned size)
+{
+	uint32_t n_entries = 1u;
+	while (n_entries < size) {
+		n_entries *= 2u;
+	}
+
+	LilvQueryCache* cache = (LilvQueryCache*)malloc(sizeof(LilvQueryCache));
+	cache->entries = (LilvQueryEntry*)calloc(n_entries, sizeof(LilvQueryEntry));
+	cache->mask    = n_entries - 1u;
+	cache->generation = 0u;
+	return cache;
+}
+
+static void
+lilv_query_entry_clear(LilvWorld* world, LilvQueryEntry* entry)
+{
+	if (entry->kind != LILV_QUERY_NONE) {
+		lilv_nodes_free(entry->values);
+		sord_node_free(world->world, entry->object);
+		sord_node_free(world->world, entry->predicate);
+		sord_node_free(world->world, entry->subject);
+		memset(entry, 0, sizeof(LilvQueryEntry));
+	}
+}
+
+/** Forget all entries in `cache`.  The world mutex must be held. */
+static void
+lilv_query_cache_clear(LilvWorld* world, LilvQueryCache* cache)
+{
+	for (uint32_t i = 0u; i <= cache->mask; ++i) {
+		lilv_query_entry_clear(world, &cache->entries[i]);
+	}
+}
+
+void
+lilv_query_cache_free(LilvWorld* world, LilvQueryCache* cache)
+{
+	if (cache) {
+		lilv_world_lock(world);
+		lilv_query_cache_clear(world, cache);
+		lilv_world_unlock(world);
+		free(cache->entries);
+		free(cache);
+	}
+}
+
+/**
+   Return the cache entry for a pattern, which may hold another pattern.
+
+   This must be called with the world mutex held.  Entries from before the
+   model or language last changed are forgotten first.
+*/
+static LilvQueryEntry*
+lilv_query_cache_slot(LilvWorld*      world,
+                      LilvQueryKind   kind,
+                      const SordNode* subject,
+                      const SordNode* predicate,
+                      const SordNode* object)
+{
+	LilvQueryCache* const cache = world->query_cache;
+	if (cache->generation != world->query_generation) {
+		lilv_query_cache_clear(world, cache);
+		cache->generation = world->query_generation;
+	}
+
+	// Combine the (interned) node addresses, dropping alignment bits
+	uintptr_t h = (uintptr_t)kind;
+	h           = h * 31u + ((uintptr_t)subject >> 4u);
+	h           = h * 31u + ((uintptr_t)predicate >> 4u);
+	h           = h * 31u + ((uintptr_t)object >> 4u);
+
+	return &cache->entries[((uint32_t)h * 2654435761u) & cache->mask];
+}
+
+static bool
+lilv_query_entry_matches(const LilvQueryEntry* entry,
+                         LilvQueryKind         kind,
+                         const SordNode*       subject,
+                         const SordNode*       predicate,
+                         const SordNode*       object)
+{
+	return entry->kind == kind && entry->subject == subject &&
+	       entry->predicate == predicate && entry->object == object;
+}
+
+/** Replace `entry` with a result.  The world mutex must be held. */
+static void
+lilv_query_entry_set(LilvWorld*      world,
+                     LilvQueryEntry* entry,
+                     LilvQueryKind   kind,
+                     const SordNode* subject,
+                     const SordNode* predicate,
+                     const SordNode* object)
+{
+	lilv_query_entry_clear(world, entry);
+	entry->kind      = kind;
+	entry->subject   = subject ? sord_node_copy(subject) : NULL;
+	entry->predicate = predicate ? sord_node_copy(predicate) : NULL;
+	entry->object    = object ? sord_node_copy(object) : NULL;
+}
+
+/** Return a new copy of `values`, or of only its first value. */
+static LilvNodes*
+lilv_query_result(const LilvNodes* values, bool first_only)
+{
+	if (!values) {
+		return NULL;
+	} else if (!first_only) {
+		return lilv_nodes_merge(values, NULL);
+	}
+
+	LilvNodes* const result = lilv_nodes_new();
+	lilv_collection_insert(result,
+	                       lilv_node_duplicate(lilv_nodes_get_first(values)));
+	return result;
+}
+
+LilvNodes*
+lilv_world_find_nodes_cached(LilvWorld*      world,
+                             const SordNode* subject,
+                             const SordNode* predicate,
+                             const SordNode* object,
+                             bool            first_only)
+{
+	if (!world->query_cache) {
+		return lilv_world_find_nodes_internal(
+			world, subject, predicate, object);
+	}
+
+	// Hold a read lock so that the world can not change until this returns
+	lilv_world_read_lock(world);
+
+	lilv_world_lock(world);
+	LilvQueryEntry* entry = lilv_query_cache_slot(
+		world, LILV_QUERY_FIND, subject, predicate, object);
+	if (lilv_query_entry_matches(
+		    entry, LILV_QUERY_FIND, subject, predicate, object)) {
+		++world->stats.n_query_cache_hits;
+		LilvNodes* const result = lilv_query_result(entry->values, first_only);
+		lilv_world_unlock(world);
+		lilv_world_read_unlock(world);
+		return result;
+	}
+
+	++world->stats.n_query_cache_misses;
+	const uint64_t generation = world->query_generation;
+	lilv_world_unlock(world);
+
+	LilvNodes* const values =
+		lilv_world_find_nodes_internal(world, subject, predicate, object);
+	LilvNodes* const result = lilv_query_result(values, first_only);
+
+	lilv_world_lock(world);
+	if (world->query_generation == generation) {
+		// Remember this result, replacing whatever was in its slot
+		entry = lilv_query_cache_slot(
+			world, LILV_QUERY_FIND, subject, predicate, object);
+		lilv_query_entry_set(
+			world, entry, LILV_QUERY_FIND, subject, predicate, object);
+		entry->values = values;
+	} else {
+		lilv_nodes_free(values);
+	}
+	lilv_world_unlock(world);
+
+	lilv_world_read_unlock(world);
+	return result;
+}
+
+bool
+lilv_world_ask_cached(LilvWorld*      world,
+                      const SordNode* subject,
+                      const SordNode* predicate,
+                      const SordNode* object)
+{
+	if (!world->query_cache) {
+		return lilv_world_ask_internal(world, subject, predicate, object);
+	}
+
+	lilv_world_read_lock(world);
+
+	lilv_world_lock(world);
+	LilvQueryEntry* entry = lilv_query_cache_slot(
+		world, LILV_QUERY_ASK, subject, predicate, object);
+
+	bool answer = false;
+	if (lilv_query_entry_matches(
+		    entry, LILV_QUERY_ASK, subject, predicate, object)) {
+		++world->stats.n_query_cache_hits;
+		answer = entry->answer;
+	} else {
+		// Asking is quick enough to do with the mutex held
+		++world->stats.n_query_cache_misses;
+		answer = lilv_world_ask_internal(world, subject, predicate, object);
+		lilv_query_entry_set(
+			world, entry, LILV_QUERY_ASK, subject, predicate, object);
+		entry->answer = answer;
+	}
+
+	lilv_world_unlock(world);
+	lilv_world_read_unlock(world);
+	return answer;
+}
@@ -18,13 +18,13 @@
 
 #include "lilv/lilv.h"
 
-#include <stdlib.h>
 
 /** Ownership of value and label is taken */
 LilvScalePoint*
 lilv_scale_point_new(LilvNode* value, LilvNode* label)
 {
-	LilvScalePoint* point = (LilvScalePoint*)malloc(sizeof(LilvScalePoint));
+	LilvScalePoint* point =
+		(LilvScalePoint*)lilv_pool_alloc(value->world->scale_point_pool);
 	point->value = value;
 	point->label = label;
 	return point;
@@ -34,9 +34,11 @@ void
 lilv_scale_point_free(LilvScalePoint* point)
 {
 	if (point) {
+		LilvWorld* const world = point->value->world;
+
 		lilv_node_free(point->value);
 		lilv_node_free(point->label);
-		free(point);
+		lilv_pool_release(world->scale_point_pool, point);
 	}
 }
 
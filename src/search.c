@@ -0,0 +1,411 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  The text index is a sorted array of every word in the name, label, author
+  name, and project name of every plugin.  Each distinct word refers to the
+  range of postings (plugin and field) for it, so words can be found by prefix
+  with a binary search, or by substring with a scan of distinct words only.
+*/
+
+/** Minimum length of a search word that is matched within other words. */
+#define LILV_SEARCH_MIN_SUBSTRING 3u
+
+/** A field of plugin data that is searched, with its weight in ranking. */
+typedef enum {
+	LILV_SEARCH_AUTHOR  = 1u,
+	LILV_SEARCH_PROJECT = 2u,
+	LILV_SEARCH_LABEL   = 4u,
+	LILV_SEARCH_NAME    = 8u,
+} LilvSearchField;
+
+/** Number of fields searched for each plugin. */
+#define LILV_SEARCH_N_FIELDS 4u
+
+/** An occurrence of a word in a field of some plugin. */
+typedef struct {
+	const char* word;    ///< Lower case word, in `strings`
+	uint32_t    plugin;  ///< Index of plugin in `plugins`
+	uint32_t    weight;  ///< Field weight, doubled for the first word
+} LilvSearchPosting;
+
+/** A distinct word, and the range of postings where it occurs. */
+typedef struct {
+	const char* word;   ///< Lower case word, in `strings`
+	uint32_t    begin;  ///< Index of first posting
+	uint32_t    end;    ///< Index one past the last posting
+} LilvSearchWord;
+
+struct LilvTextIndexImpl {
+	const LilvPlugin** plugins;        ///< Plugins in URI order
+	uint32_t           n_plugins;      ///< Number of plugins
+	char**             strings;        ///< Split lower case field values
+	uint32_t           n_strings;      ///< Number of strings
+	LilvSearchPosting* postings;       ///< Postings sorted by word
+	uint32_t           n_postings;     ///< Number of postings
+	uint32_t           postings_size;  ///< Allocated number of postings
+	LilvSearchWord*    words;          ///< Distinct words, sorted
+	uint32_t           n_words;        ///< Number of distinct words
+};
+
+static bool
+lilv_is_word_char(const char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+	       (unsigned char)c >= 0x80;
+}
+
+/**
+   Convert `str` to lower case and terminate words in place.
+
+   Only ASCII is folded, other UTF-8 bytes are kept as they are.
+*/
+static void
+lilv_search_fold(char* str)
+{
+	for (char* s = str; *s; ++s) {
+		if (*s >= 'A' && *s <= 'Z') {
+			*s = (char)(*s - 'A' + 'a');
+		} else if (!lilv_is_word_char(*s)) {
+			*s = '\0';
+		}
+	}
+}
+
+static void
+lilv_text_index_add(LilvTextIndex*  index,
+                    uint32_t        plugin,
+                    LilvSearchField field,
+                    LilvNode*       value)
+{
+	if (!value || !lilv_node_is_string(value)) {
+		lilv_node_free(value);
+		return;
+	}
+
+	const char* const str = lilv_node_as_string(value);
+	const size_t      len = strlen(str);
+	char* const       buf = lilv_strdup(str);
+	lilv_node_free(value);
+	lilv_search_fold(buf);
+
+	index->strings[index->n_strings++] = buf;
+
+	bool first = true;
+	for (size_t i = 0; i < len; ++i) {
+		if (buf[i] && (i == 0 || !buf[i - 1])) {
+			if (index->n_postings == index->postings_size) {
+				index->postings_size = index->postings_size * 2u + 16u;
+				index->postings      = (LilvSearchPosting*)realloc(
+					index->postings,
+					index->postings_size * sizeof(LilvSearchPosting));
+			}
+
+			LilvSearchPosting* const posting =
+				&index->postings[index->n_postings++];
+
+			posting->word   = buf + i;
+			posting->plugin = plugin;
+			posting->weight = first ? 2u * field : field;
+			first           = false;
+		}
+	}
+}
+
+/** Return the first value of `predicate` on `subject`, or NULL. */
+static LilvNode*
+lilv_search_get(LilvWorld*      world,
+                const LilvNode* subject,
+                const LilvNode* predicate)
+{
+	LilvNodes* const values =
+		lilv_world_find_nodes(world, subject, predicate, NULL);
+	LilvNode* const value = lilv_node_duplicate(lilv_nodes_get_first(values));
+
+	lilv_nodes_free(values);
+	return value;
+}
+
+static int
+lilv_posting_cmp(const void* a, const void* b)
+{
+	const LilvSearchPosting* const pa = (const LilvSearchPosting*)a;
+	const LilvSearchPosting* const pb = (const LilvSearchPosting*)b;
+
+	const int st = strcmp(pa->word, pb->word);
+	if (st) {
+		return st;
+	}
+
+	return (pa->plugin < pb->plugin) ? -1 : (pa->plugin > pb->plugin) ? 1 : 0;
+}
+
+static LilvTextIndex*
+lilv_text_index_new(LilvWorld* world)
+{
+	LilvTextIndex* const index =
+		(LilvTextIndex*)calloc(1, sizeof(LilvTextIndex));
+
+	LilvNode* const doap_name  = lilv_new_uri(world, LILV_NS_DOAP "name");
+	LilvNode* const rdfs_label = lilv_new_uri(world, LILV_NS_RDFS "label");
+
+	const unsigned n_plugins = lilv_plugins_size(world->plugins);
+
+	index->plugins =
+		(const LilvPlugin**)calloc(n_plugins + 1, sizeof(LilvPlugin*));
+	index->strings =
+		(char**)calloc(LILV_SEARCH_N_FIELDS * n_plugins + 1, sizeof(char*));
+
+	// Gather the words of every field with the usual (language aware) getters
+	LILV_FOREACH(plugins, i, world->plugins) {
+		const LilvPlugin* const plugin = lilv_plugins_get(world->plugins, i);
+		const uint32_t          p      = index->n_plugins++;
+		const LilvNode* const   uri    = lilv_plugin_get_uri(plugin);
+
+		index->plugins[p] = plugin;
+
+		lilv_text_index_add(
+			index, p, LILV_SEARCH_NAME, lilv_plugin_get_name(plugin));
+		lilv_text_index_add(index,
+		                    p,
+		                    LILV_SEARCH_LABEL,
+		                    lilv_search_get(world, uri, rdfs_label));
+		lilv_text_index_add(
+			index, p, LILV_SEARCH_AUTHOR, lilv_plugin_get_author_name(plugin));
+
+		LilvNode* const project = lilv_plugin_get_project(plugin);
+		if (project) {
+			lilv_text_index_add(index,
+			                    p,
+			                    LILV_SEARCH_PROJECT,
+			                    lilv_search_get(world, project, doap_name));
+			lilv_node_free(project);
+		}
+	}
+
+	lilv_node_free(rdfs_label);
+	lilv_node_free(doap_name);
+
+	// Sort postings by word, then group them by distinct word
+	qsort(index->postings,
+	      index->n_postings,
+	      sizeof(LilvSearchPosting),
+	      lilv_posting_cmp);
+
+	index->words =
+		(LilvSearchWord*)calloc(index->n_postings + 1, sizeof(LilvSearchWord));
+
+	for (uint32_t i = 0; i < index->n_postings; ++i) {
+		const char* const word = index->postings[i].word;
+		if (!index->n_words ||
+		    strcmp(index->words[index->n_words - 1].word, word)) {
+			LilvSearchWord* const w = &index->words[index->n_words++];
+			w->word                 = word;
+			w->begin                = i;
+		}
+
+		index->words[index->n_words - 1].end = i + 1;
+	}
+
+	return index;
+}
+
+void
+lilv_text_index_free(LilvTextIndex* index)
+{
+	if (index) {
+		for (uint32_t i = 0; i < index->n_strings; ++i) {
+			free(index->strings[i]);
+		}
+
+		free(index->words);
+		free(index->postings);
+		free(index->strings);
+		free(index->plugins);
+		free(index);
+	}
+}
+
+void
+lilv_world_load_text_index_if_necessary(LilvWorld* world)
+{
+	lilv_world_read_lock(world);
+	const bool indexed = world->text_index;
+	lilv_world_read_unlock(world);
+	if (indexed) {
+		return;
+	}
+
+	// Build without holding a lock, since the getters take locks themselves
+	LilvTextIndex* index = lilv_text_index_new(world);
+
+	lilv_world_write_lock(world);
+	if (!world->text_index) {
+		world->text_index = index;
+		index             = NULL;
+	}
+	lilv_world_write_unlock(world);
+
+	lilv_text_index_free(index);
+}
+
+/** Add the score of every posting of `word` to `scores`. */
+static void
+lilv_search_score_word(const LilvTextIndex* index,
+                       const LilvSearchWord* word,
+                       uint32_t              match,
+                       uint32_t*             scores)
+{
+	for (uint32_t i = word->begin; i < word->end; ++i) {
+		const LilvSearchPosting* const posting = &index->postings[i];
+		const uint32_t                 score   = match * posting->weight;
+		if (score > scores[posting->plugin]) {
+			scores[posting->plugin] = score;
+		}
+	}
+}
+
+/** Set `scores` to the best score of each plugin for the search `word`. */
+static void
+lilv_search_score(const LilvTextIndex* index,
+                  const char*          word,
+                  uint32_t*            scores)
+{
+	const size_t len = strlen(word);
+
+	// Binary search for the first word that is not less than `word`
+	uint32_t lo = 0;
+	uint32_t hi = index->n_words;
+	while (lo < hi) {
+		const uint32_t mid = lo + (hi - lo) / 2u;
+		if (strcmp(index->words[mid].word, word) < 0) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	// Score words that start with `word`, exact matches highest
+	for (uint32_t i = lo;
+	     i < index->n_words && !strncmp(index->words[i].word, word, len);
+	     ++i) {
+		const LilvSearchWord* const w = &index->words[i];
+		lilv_search_score_word(index, w, w->word[len] ? 3u : 4u, scores);
+	}
+
+	// Score words that contain `word` elsewhere, lowest
+	if (len >= LILV_SEARCH_MIN_SUBSTRING) {
+		for (uint32_t i = 0; i < index->n_words; ++i) {
+			const LilvSearchWord* const w = &index->words[i];
+			if (w->word[0] && strstr(w->word + 1, word)) {
+				lilv_search_score_word(index, w, 1u, scores);
+			}
+		}
+	}
+}
+
+/** A plugin that matches a search, with its total score. */
+typedef struct {
+	uint32_t plugin;
+	uint32_t score;
+} LilvSearchResult;
+
+static int
+lilv_search_result_cmp(const void* a, const void* b)
+{
+	const LilvSearchResult* const ra = (const LilvSearchResult*)a;
+	const LilvSearchResult* const rb = (const LilvSearchResult*)b;
+
+	if (ra->score != rb->score) {
+		return (ra->score > rb->score) ? -1 : 1;
+	}
+
+	return (ra->plugin < rb->plugin) ? -1 : (ra->plugin > rb->plugin) ? 1 : 0;
+}
+
+unsigned
+lilv_world_search_plugins(LilvWorld*         world,
+                          const char*        text,
+                          const LilvPlugin** results,
+                          unsigned           max_results)
+{
+	lilv_world_load_text_index_if_necessary(world);
+	lilv_world_read_lock(world);
+
+	const LilvTextIndex* const index = world->text_index;
+
+	const uint32_t n_plugins = index->n_plugins;
+	char* const    query     = lilv_strdup(text ? text : "");
+	const size_t   len       = strlen(query);
+	bool           first     = true;
+
+	uint32_t* const totals = (uint32_t*)calloc(n_plugins + 1, sizeof(uint32_t));
+	uint32_t* const scores = (uint32_t*)calloc(n_plugins + 1, sizeof(uint32_t));
+
+	// Every word in the query must match, scores of each word are summed
+	lilv_search_fold(query);
+	for (size_t i = 0; i < len; ++i) {
+		if (!query[i] || (i > 0 && query[i - 1])) {
+			continue;
+		}
+
+		memset(scores, 0, n_plugins * sizeof(uint32_t));
+		lilv_search_score(index, query + i, scores);
+
+		for (uint32_t p = 0; p < n_plugins; ++p) {
+			totals[p] = (first || totals[p]) && scores[p]
+			                ? totals[p] + scores[p]
+			                : 0u;
+		}
+
+		first = false;
+	}
+
+	// Collect matching plugins and sort them by score
+	LilvSearchResult* const matches = (LilvSearchResult*)calloc(
+		n_plugins + 1, sizeof(LilvSearchResult));
+
+	uint32_t n_matches = 0;
+	for (uint32_t p = 0; p < n_plugins; ++p) {
+		if (totals[p]) {
+			matches[n_matches].plugin  = p;
+			matches[n_matches++].score = totals[p];
+		}
+	}
+
+	qsort(matches, n_matches, sizeof(LilvSearchResult), lilv_search_result_cmp);
+
+	for (uint32_t i = 0; results && i < n_matches && i < max_results; ++i) {
+		results[i] = index->plugins[matches[i].plugin];
+	}
+
+	lilv_world_read_unlock(world);
+
+	free(matches);
+	free(scores);
+	free(totals);
+	free(query);
+	return n_matches;
+}
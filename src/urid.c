@@ -0,0 +1,340 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+#include "lv2/core/lv2.h"
+#include "lv2/urid/urid.h"
+#include "sord/sord.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+  The URID map stores the interned world node for each URID in an array of
+  segments which never move, so unmapping is an array index.  Mapping is a
+  lookup in an open addressing hash table of URIDs.  Both are only written
+  with the world mutex held, and new entries are published with release
+  stores, so readers never lock.  Tables replaced by larger ones are kept
+  until the map is freed, since readers may still be using them.
+*/
+
+/** Number of entries in the first segment, as a power of two. */
+#define LILV_URID_SEGMENT_BITS 6u
+
+/** Maximum number of segments, each twice as large as the last. */
+#define LILV_URID_N_SEGMENTS 26u
+
+/** Size of the initial hash table. */
+#define LILV_URID_INITIAL_SLOTS 128u
+
+/** A mapped URI. */
+typedef struct {
+	SordNode* node;  ///< Interned URI node
+	uint32_t  hash;  ///< Hash of URI string
+} LilvURIDEntry;
+
+/** A hash table from URI to URID, where 0 is an empty slot. */
+typedef struct LilvURIDTableImpl {
+	struct LilvURIDTableImpl* replaced;  ///< Previous (smaller) table
+	uint32_t                  mask;      ///< Number of slots minus one
+	uint32_t                  slots[];   ///< URIDs
+} LilvURIDTable;
+
+struct LilvURIDMapImpl {
+	LilvWorld*     world;
+	LilvURIDEntry* segments[LILV_URID_N_SEGMENTS];  ///< Entries by URID
+	LilvURIDTable* table;                           ///< Current hash table
+	uint32_t       n_urids;                         ///< Number of URIDs
+	LV2_URID_Map   map;                             ///< Map interface
+	LV2_URID_Unmap unmap;                           ///< Unmap interface
+	LV2_Feature    map_feature;                     ///< Map feature
+	LV2_Feature    unmap_feature;                   ///< Unmap feature
+};
+
+static uint32_t
+lilv_atomic_load(const uint32_t* ptr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+	return *(const volatile uint32_t*)ptr;  // Acquire with MSVC
+#endif
+}
+
+static void
+lilv_atomic_store(uint32_t* ptr, uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+	*(volatile uint32_t*)ptr = value;  // Release with MSVC
+#endif
+}
+
+static void*
+lilv_atomic_load_ptr(void* const* ptr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#else
+	return *(void* const volatile*)ptr;  // Acquire with MSVC
+#endif
+}
+
+static void
+lilv_atomic_store_ptr(void** ptr, void* value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#else
+	*(void* volatile*)ptr = value;  // Release with MSVC
+#endif
+}
+
+/** FNV-1a hash of a string. */
+static uint32_t
+lilv_urid_hash(const char* str)
+{
+	uint32_t hash = 2166136261u;
+	for (const char* s = str; *s; ++s) {
+		hash = (hash ^ (uint8_t)*s) * 16777619u;
+	}
+
+	return hash;
+}
+
+/**
+   Return the segment that holds index `i`, and set `offset` to its offset.
+
+   Segment s holds indices from 2^s - 1 to 2^(s+1) - 2, in units of the size
+   of the first segment.
+*/
+static unsigned
+lilv_urid_segment(uint32_t i, uint32_t* offset)
+{
+	uint32_t n = (i >> LILV_URID_SEGMENT_BITS) + 1u;
+	unsigned s = 0u;
+	while (n >>= 1u) {
+		++s;
+	}
+
+	*offset = i - (((1u << s) - 1u) << LILV_URID_SEGMENT_BITS);
+	return s;
+}
+
+/** Return the entry for `urid`, which must have been mapped. */
+static LilvURIDEntry*
+lilv_urid_entry(const LilvURIDMap* map, LV2_URID urid)
+{
+	uint32_t       offset = 0u;
+	const unsigned s      = lilv_urid_segment(urid - 1u, &offset);
+
+	LilvURIDEntry* const segment = (LilvURIDEntry*)lilv_atomic_load_ptr(
+		(void* const*)&map->segments[s]);
+
+	return &segment[offset];
+}
+
+static LilvURIDTable*
+lilv_urid_table_new(uint32_t n_slots)
+{
+	LilvURIDTable* const table = (LilvURIDTable*)calloc(
+		1, sizeof(LilvURIDTable) + n_slots * sizeof(uint32_t));
+
+	table->mask = n_slots - 1u;
+	return table;
+}
+
+/** Return the URID for `uri` in `table`, or zero. */
+static LV2_URID
+lilv_urid_find(const LilvURIDMap*   map,
+               const LilvURIDTable* table,
+               const char*          uri,
+               uint32_t             hash)
+{
+	for (uint32_t i = hash & table->mask;; i = (i + 1u) & table->mask) {
+		const LV2_URID urid = lilv_atomic_load(&table->slots[i]);
+		if (!urid) {
+			return 0u;
+		}
+
+		const LilvURIDEntry* const entry = lilv_urid_entry(map, urid);
+		if (entry->hash == hash &&
+		    !strcmp((const char*)sord_node_get_string(entry->node), uri)) {
+			return urid;
+		}
+	}
+}
+
+static void
+lilv_urid_table_insert(LilvURIDTable* table, uint32_t hash, LV2_URID urid)
+{
+	uint32_t i = hash & table->mask;
+	while (table->slots[i]) {
+		i = (i + 1u) & table->mask;
+	}
+
+	lilv_atomic_store(&table->slots[i], urid);
+}
+
+/** Add a new URID for `uri`, with the world mutex held. */
+static LV2_URID
+lilv_urid_add(LilvURIDMap* map, const char* uri, uint32_t hash)
+{
+	const uint32_t i      = map->n_urids;
+	uint32_t       offset = 0u;
+	const unsigned s      = lilv_urid_segment(i, &offset);
+	if (s >= LILV_URID_N_SEGMENTS) {
+		LILV_ERRORF("Too many URIDs to map <%s>\n", uri);
+		return 0u;
+	}
+
+	if (!map->segments[s]) {
+		const size_t size = (size_t)1u << (s + LILV_URID_SEGMENT_BITS);
+		lilv_atomic_store_ptr((void**)&map->segments[s],
+		                      calloc(size, sizeof(LilvURIDEntry)));
+	}
+
+	// Grow the table first if it would be over half full
+	LilvURIDTable* table = map->table;
+	if ((i + 1u) * 2u > table->mask + 1u) {
+		LilvURIDTable* const bigger =
+			lilv_urid_table_new((table->mask + 1u) * 2u);
+		for (LV2_URID u = 1u; u <= i; ++u) {
+			lilv_urid_table_insert(bigger, lilv_urid_entry(map, u)->hash, u);
+		}
+
+		bigger->replaced = table;
+		lilv_atomic_store_ptr((void**)&map->table, bigger);
+		table = bigger;
+	}
+
+	// Write the entry, then make it visible to unmap, then to map
+	const LV2_URID       urid  = i + 1u;
+	LilvURIDEntry* const entry = lilv_urid_entry(map, urid);
+	entry->node = sord_new_uri(map->world->world, (const uint8_t*)uri);
+	entry->hash = hash;
+
+	lilv_atomic_store(&map->n_urids, urid);
+	lilv_urid_table_insert(table, hash, urid);
+	return urid;
+}
+
+static LV2_URID
+lilv_urid_map(LV2_URID_Map_Handle handle, const char* uri)
+{
+	LilvURIDMap* const map  = (LilvURIDMap*)handle;
+	const uint32_t     hash = lilv_urid_hash(uri);
+
+	const LilvURIDTable* const table =
+		(const LilvURIDTable*)lilv_atomic_load_ptr((void* const*)&map->table);
+
+	const LV2_URID urid = lilv_urid_find(map, table, uri, hash);
+	if (urid) {
+		return urid;
+	}
+
+	// Not found, so add it, unless another thread just did
+	lilv_world_lock(map->world);
+	LV2_URID added = lilv_urid_find(map, map->table, uri, hash);
+	if (!added) {
+		added = lilv_urid_add(map, uri, hash);
+	}
+	lilv_world_unlock(map->world);
+
+	return added;
+}
+
+static const char*
+lilv_urid_unmap(LV2_URID_Unmap_Handle handle, LV2_URID urid)
+{
+	const LilvURIDMap* const map = (const LilvURIDMap*)handle;
+	if (!urid || urid > lilv_atomic_load(&map->n_urids)) {
+		return NULL;
+	}
+
+	return (const char*)sord_node_get_string(lilv_urid_entry(map, urid)->node);
+}
+
+LilvURIDMap*
+lilv_urid_map_new(LilvWorld* world)
+{
+	LilvURIDMap* const map = (LilvURIDMap*)calloc(1, sizeof(LilvURIDMap));
+
+	map->world              = world;
+	map->table              = lilv_urid_table_new(LILV_URID_INITIAL_SLOTS);
+	map->map.handle         = map;
+	map->map.map            = lilv_urid_map;
+	map->unmap.handle       = map;
+	map->unmap.unmap        = lilv_urid_unmap;
+	map->map_feature.URI    = LV2_URID__map;
+	map->map_feature.data   = &map->map;
+	map->unmap_feature.URI  = LV2_URID__unmap;
+	map->unmap_feature.data = &map->unmap;
+
+	return map;
+}
+
+void
+lilv_urid_map_free(LilvURIDMap* map)
+{
+	if (!map) {
+		return;
+	}
+
+	for (LV2_URID u = 1u; u <= map->n_urids; ++u) {
+		sord_node_free(map->world->world, lilv_urid_entry(map, u)->node);
+	}
+
+	for (unsigned s = 0u; s < LILV_URID_N_SEGMENTS; ++s) {
+		free(map->segments[s]);
+	}
+
+	for (LilvURIDTable* t = map->table; t;) {
+		LilvURIDTable* const replaced = t->replaced;
+		free(t);
+		t = replaced;
+	}
+
+	free(map);
+}
+
+LV2_URID_Map*
+lilv_world_get_urid_map(LilvWorld* world)
+{
+	return &world->urid_map->map;
+}
+
+LV2_URID_Unmap*
+lilv_world_get_urid_unmap(LilvWorld* world)
+{
+	return &world->urid_map->unmap;
+}
+
+const LV2_Feature*
+lilv_world_get_urid_map_feature(LilvWorld* world)
+{
+	return &world->urid_map->map_feature;
+}
+
+const LV2_Feature*
+lilv_world_get_urid_unmap_feature(LilvWorld* world)
+{
+	return &world->urid_map->unmap_feature;
+}
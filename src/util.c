@@ -14,6 +14,8 @@
   OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 */
 
+#define _POSIX_C_SOURCE 200809L  /* for clock_gettime */
+
 #include "filesystem.h"
 #include "lilv_internal.h"
 
@@ -23,6 +25,10 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#ifdef HAVE_CLOCK_GETTIME
+#    include <time.h>
+#endif
+
 #include <ctype.h>
 #include <errno.h>
 #include <stdarg.h>
@@ -108,13 +114,12 @@ lilv_file_uri_parse(const char* uri, char** hostname)
 	return (char*)serd_file_uri_parse((const uint8_t*)uri, (uint8_t**)hostname);
 }
 
-/** Return the current LANG converted to Turtle (i.e. RFC3066) style.
- * For example, if LANG is set to "en_CA.utf-8", this returns "en-ca".
+/** Return a LANG value converted to Turtle (i.e. RFC3066) style.
+ * For example, if `env_lang` is "en_CA.utf-8", this returns "en-ca".
  */
 char*
-lilv_get_lang(void)
+lilv_normalize_lang(const char* env_lang)
 {
-	const char* const env_lang = getenv("LANG");
 	if (!env_lang || !strcmp(env_lang, "")
 	    || !strcmp(env_lang, "C") || !strcmp(env_lang, "POSIX")) {
 		return NULL;
@@ -136,7 +141,7 @@ lilv_get_lang(void)
 			lang[i] = '\0';
 			break;
 		} else {
-			LILV_ERRORF("Illegal LANG `%s' ignored\n", env_lang);
+			LILV_ERRORF("Illegal language `%s' ignored\n", env_lang);
 			free(lang);
 			return NULL;
 		}
@@ -290,3 +295,22 @@ lilv_get_latest_copy(const char* path, const char* copy_path)
 	return latest.latest;
 }
 
+
+/** Return the time in seconds since some arbitrary point, or zero. */
+double
+lilv_time_now(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER freq;
+	LARGE_INTEGER count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (double)count.QuadPart / (double)freq.QuadPart;
+#elif defined(HAVE_CLOCK_GETTIME)
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 0.000000001;
+#else
+	return 0.0;
+#endif
+}
@@ -0,0 +1,368 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#include "filesystem.h"
+#include "lilv_internal.h"
+
+#include "lilv/lilv.h"
+#include "serd/serd.h"
+#include "zix/common.h"
+#include "zix/tree.h"
+
+#ifdef HAVE_INOTIFY
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#endif
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_INOTIFY
+
+/*
+  Every directory in LV2_PATH is watched for bundles being added or removed,
+  and every bundle directory is watched for files being written, added, or
+  removed.  Events are only read when the host polls, and are first reduced to
+  a set of changed bundle paths, so that each bundle is reloaded at most once
+  no matter how many files in it were touched.
+*/
+
+#define LILV_WATCH_PATH_MASK \
+	(IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+#define LILV_WATCH_BUNDLE_MASK (LILV_WATCH_PATH_MASK | IN_CLOSE_WRITE)
+
+typedef struct {
+	int   wd;         ///< Watch descriptor
+	char* path;       ///< Directory path, with trailing slash for bundles
+	bool  is_bundle;  ///< True for a bundle, false for an LV2_PATH directory
+} LilvWatchDir;
+
+struct LilvWatchImpl {
+	int      fd;    ///< Inotify instance
+	ZixTree* dirs;  ///< Watched directories, ordered by watch descriptor
+};
+
+/** State for registering watches and collecting changes during a poll. */
+typedef struct {
+	LilvWatch* watch;
+	ZixTree*   changed;  ///< Paths of changed bundles, ordered by path
+} LilvWatchScan;
+
+static int
+lilv_watch_dir_cmp(const void* a, const void* b, void* user_data)
+{
+	const int a_wd = ((const LilvWatchDir*)a)->wd;
+	const int b_wd = ((const LilvWatchDir*)b)->wd;
+	return (a_wd < b_wd) ? -1 : (a_wd > b_wd) ? 1 : 0;
+}
+
+static void
+lilv_watch_dir_free(void* ptr)
+{
+	LilvWatchDir* dir = (LilvWatchDir*)ptr;
+	if (dir) {
+		free(dir->path);
+		free(dir);
+	}
+}
+
+static int
+lilv_path_cmp(const void* a, const void* b, void* user_data)
+{
+	return strcmp((const char*)a, (const char*)b);
+}
+
+static LilvWatchDir*
+lilv_watch_find(LilvWatch* watch, int wd)
+{
+	LilvWatchDir key  = { wd, NULL, false };
+	ZixTreeIter* iter = NULL;
+	if (!zix_tree_find(watch->dirs, &key, &iter)) {
+		return (LilvWatchDir*)zix_tree_get(iter);
+	}
+	return NULL;
+}
+
+static void
+lilv_watch_add_dir(LilvWatch* watch, const char* path, bool is_bundle)
+{
+	const uint32_t mask = is_bundle ? LILV_WATCH_BUNDLE_MASK
+	                                : LILV_WATCH_PATH_MASK;
+
+	const int wd = inotify_add_watch(watch->fd, path, mask);
+	if (wd < 0) {
+		return;
+	}
+
+	// Watching a directory again returns the same descriptor, so update it
+	LilvWatchDir* dir = lilv_watch_find(watch, wd);
+	if (dir) {
+		free(dir->path);
+	} else {
+		dir     = (LilvWatchDir*)calloc(1, sizeof(LilvWatchDir));
+		dir->wd = wd;
+		zix_tree_insert(watch->dirs, dir, NULL);
+	}
+
+	dir->path      = lilv_strdup(path);
+	dir->is_bundle = is_bundle;
+}
+
+static void
+lilv_watch_remove_dir(LilvWatch* watch, int wd)
+{
+	LilvWatchDir key  = { wd, NULL, false };
+	ZixTreeIter* iter = NULL;
+	if (!zix_tree_find(watch->dirs, &key, &iter)) {
+		zix_tree_remove(watch->dirs, iter);
+	}
+}
+
+/** Add `path` to the set of changed bundles, taking ownership of it. */
+static void
+lilv_watch_mark_changed(ZixTree* changed, char* path)
+{
+	if (zix_tree_insert(changed, path, NULL)) {
+		free(path);
+	}
+}
+
+static void
+watch_path_entry(const char* dir, const char* name, void* data)
+{
+	LilvWatchScan* const scan = (LilvWatchScan*)data;
+	char* const          path = lilv_strjoin(dir, "/", name, "/", NULL);
+
+	if (lilv_is_directory(path)) {
+		lilv_watch_add_dir(scan->watch, path, true);
+	}
+
+	if (scan->changed) {
+		lilv_watch_mark_changed(scan->changed, path);
+	} else {
+		free(path);
+	}
+}
+
+static void
+watch_path_dir(const char* dir_path, void* data)
+{
+	LilvWatchScan* const scan = (LilvWatchScan*)data;
+
+	lilv_watch_add_dir(scan->watch, dir_path, false);
+	lilv_dir_for_each(dir_path, scan, watch_path_entry);
+}
+
+static void
+lilv_watch_handle_event(LilvWatchScan*              scan,
+                        const struct inotify_event* event)
+{
+	LilvWatchDir* const dir = lilv_watch_find(scan->watch, event->wd);
+	if (!dir) {
+		return;
+	}
+
+	if (event->mask & IN_IGNORED) {
+		// Directory was removed, the kernel has already dropped the watch
+		lilv_watch_remove_dir(scan->watch, event->wd);
+	} else if (dir->is_bundle) {
+		lilv_watch_mark_changed(scan->changed, lilv_strdup(dir->path));
+	} else if (event->len > 0) {
+		char* const path =
+			lilv_strjoin(dir->path, "/", event->name, "/", NULL);
+		if ((event->mask & (IN_CREATE | IN_MOVED_TO)) &&
+		    lilv_is_directory(path)) {
+			lilv_watch_add_dir(scan->watch, path, true);
+		}
+
+		lilv_watch_mark_changed(scan->changed, path);
+	}
+}
+
+/** Mark every known bundle as changed after events were lost. */
+static void
+lilv_watch_rescan(LilvWorld* world, LilvWatchScan* scan)
+{
+	for (ZixTreeIter* i = zix_tree_begin(scan->watch->dirs);
+	     !zix_tree_iter_is_end(i);
+	     i = zix_tree_iter_next(i)) {
+		const LilvWatchDir* const dir = (const LilvWatchDir*)zix_tree_get(i);
+		if (dir->is_bundle) {
+			lilv_watch_mark_changed(scan->changed, lilv_strdup(dir->path));
+		}
+	}
+
+	lilv_world_for_each_path_dir(
+		lilv_world_get_lv2_path(world), scan, watch_path_dir);
+}
+
+/**
+   Bring a bundle in the world up to date with the bundle on disk.
+
+   @return True if the bundle was unloaded, loaded, or both.
+*/
+static bool
+lilv_world_update_bundle(LilvWorld* world, const char* path)
+{
+	SerdNode suri =
+		serd_node_new_file_uri((const uint8_t*)path, 0, 0, true);
+
+	LilvNode* const bundle   = lilv_new_uri(world, (const char*)suri.buf);
+	LilvNode* const manifest = lilv_world_get_manifest_uri(world, bundle);
+	char* const     manifest_path = lilv_path_join(path, "manifest.ttl");
+
+	const bool loaded = lilv_collection_find(world->loaded_files, manifest);
+	const bool exists = lilv_path_exists(manifest_path);
+
+	if (loaded) {
+		// Moves plugins to the zombie list, they are revived by loading
+		lilv_world_unload_bundle(world, bundle);
+	}
+
+	if (exists) {
+		lilv_world_load_bundle(world, bundle);
+	}
+
+	free(manifest_path);
+	lilv_node_free(manifest);
+	lilv_node_free(bundle);
+	serd_node_free(&suri);
+
+	return loaded || exists;
+}
+
+int
+lilv_world_watch(LilvWorld* world)
+{
+	if (world->watch) {
+		return 0;
+	}
+
+	const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0) {
+		LILV_ERRORF("Failed to create watch (%s)\n", strerror(errno));
+		return 1;
+	}
+
+	LilvWatch* const watch = (LilvWatch*)calloc(1, sizeof(LilvWatch));
+	watch->fd              = fd;
+	watch->dirs            = zix_tree_new(
+		false, lilv_watch_dir_cmp, NULL, lilv_watch_dir_free);
+
+	LilvWatchScan scan = { watch, NULL };
+	lilv_world_for_each_path_dir(
+		lilv_world_get_lv2_path(world), &scan, watch_path_dir);
+
+	world->watch = watch;
+	return 0;
+}
+
+int
+lilv_world_poll_changes(LilvWorld* world)
+{
+	LilvWatch* const watch = world->watch;
+	if (!watch) {
+		return -1;
+	} else if (world->frozen) {
+		LILV_ERROR("World is frozen\n");
+		return -1;
+	}
+
+	LilvWatchScan scan = {
+		watch, zix_tree_new(false, lilv_path_cmp, NULL, free)
+	};
+
+	// Read all pending events and reduce them to a set of changed bundles
+	union {
+		struct inotify_event event;
+		char                 bytes[4096];
+	} buf;
+
+	bool    overflow = false;
+	ssize_t len      = 0;
+	while ((len = read(watch->fd, buf.bytes, sizeof(buf.bytes))) > 0) {
+		for (ssize_t offset = 0; offset < len;) {
+			const struct inotify_event* const event =
+				(const struct inotify_event*)(buf.bytes + offset);
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				overflow = true;
+			} else {
+				lilv_watch_handle_event(&scan, event);
+			}
+
+			offset += (ssize_t)(sizeof(struct inotify_event) + event->len);
+		}
+	}
+
+	if (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+		LILV_ERRORF("Failed to read watch events (%s)\n", strerror(errno));
+	}
+
+	if (overflow) {
+		lilv_watch_rescan(world, &scan);
+	}
+
+	// Apply changes in path order so results do not depend on event order
+	int n_changes = 0;
+	lilv_world_write_lock(world);
+	for (ZixTreeIter* i = zix_tree_begin(scan.changed);
+	     !zix_tree_iter_is_end(i);
+	     i = zix_tree_iter_next(i)) {
+		if (lilv_world_update_bundle(world, (const char*)zix_tree_get(i))) {
+			++n_changes;
+		}
+	}
+	lilv_world_write_unlock(world);
+
+	zix_tree_free(scan.changed);
+	return n_changes;
+}
+
+void
+lilv_watch_free(LilvWatch* watch)
+{
+	if (watch) {
+		close(watch->fd);
+		zix_tree_free(watch->dirs);
+		free(watch);
+	}
+}
+
+#else // !HAVE_INOTIFY
+
+int
+lilv_world_watch(LilvWorld* world)
+{
+	return 1;
+}
+
+int
+lilv_world_poll_changes(LilvWorld* world)
+{
+	return -1;
+}
+
+void
+lilv_watch_free(LilvWatch* watch)
+{
+}
+
+#endif // HAVE_INOTIFY
@@ -24,14 +24,21 @@
 #include "zix/common.h"
 #include "zix/tree.h"
 
+#include "lv2/atom/atom.h"
 #include "lv2/core/lv2.h"
+#include "lv2/event/event.h"
 #include "lv2/presets/presets.h"
+#include "lv2/ui/ui.h"
 
 #ifdef LILV_DYN_MANIFEST
 #    include "lv2/dynmanifest/dynmanifest.h"
 #    include <dlfcn.h>
 #endif
 
+#ifdef HAVE_PTHREAD
+#    include <pthread.h>
+#endif
+
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -42,11 +49,99 @@
 static int
 lilv_world_drop_graph(LilvWorld* world, const SordNode* graph);
 
+static void
+lilv_world_set_lang(LilvWorld* world, const char* lang);
+
+/**
+   Comparator for loaded files (world->loaded_files).
+
+   These are sorted by URI string, so all the files in a bundle are adjacent.
+*/
+static int
+lilv_file_uri_cmp(const void* a, const void* b, void* user_data)
+{
+	const LilvNode* const a_node = (const LilvNode*)a;
+	const LilvNode* const b_node = (const LilvNode*)b;
+	if (a_node->node == b_node->node) {
+		return 0;
+	}
+
+	return strcmp(lilv_node_as_string(a_node), lilv_node_as_string(b_node));
+}
+
+/** Rough size of a node in a sord world, including a short string. */
+#define LILV_NODE_SIZE_ESTIMATE 96
+
+/** Number of indices in the world model: SPO and OPS, with and without graphs. */
+#define LILV_N_MODEL_INDICES 4
+
+/** Statistics for a bundle (an element of world->bundle_stats). */
+typedef struct {
+	char*  uri;         ///< Bundle URI string, with a trailing slash
+	double parse_time;  ///< Time spent parsing files in the bundle
+} LilvBundleStats;
+
+static int
+lilv_bundle_stats_cmp(const void* a, const void* b, void* user_data)
+{
+	return strcmp(((const LilvBundleStats*)a)->uri,
+	              ((const LilvBundleStats*)b)->uri);
+}
+
+static void
+lilv_bundle_stats_free(void* ptr)
+{
+	LilvBundleStats* const stats = (LilvBundleStats*)ptr;
+	free(stats->uri);
+	free(stats);
+}
+
+/** Count a scanned bundle, and start recording its parse time. */
+static void
+lilv_world_add_bundle_stats(LilvWorld* world, const LilvNode* bundle_uri)
+{
+	LilvBundleStats* const stats =
+		(LilvBundleStats*)calloc(1, sizeof(LilvBundleStats));
+
+	stats->uri = lilv_strdup(lilv_node_as_string(bundle_uri));
+	if (zix_tree_insert(world->bundle_stats, stats, NULL)) {
+		lilv_bundle_stats_free(stats);  // Bundle was scanned before
+	}
+
+	++world->stats.n_bundles;
+}
+
+/** Add time spent parsing `file_uri` to the bundle that contains it. */
+static void
+lilv_world_add_parse_time(LilvWorld* world, const char* file_uri, double time)
+{
+	LilvBundleStats key = { lilv_strdup(file_uri), 0.0 };
+
+	world->stats.parse_time += time;
+
+	// Search parent directories, since files may be in bundle subdirectories
+	for (char* sep = strrchr(key.uri, '/'); sep; sep = strrchr(key.uri, '/')) {
+		ZixTreeIter* iter = NULL;
+		sep[1]            = '\0';
+		if (!zix_tree_find(world->bundle_stats, &key, &iter)) {
+			((LilvBundleStats*)zix_tree_get(iter))->parse_time += time;
+			break;
+		}
+		sep[0] = '\0';
+	}
+
+	free(key.uri);
+}
+
 LilvWorld*
 lilv_world_new(void)
 {
 	LilvWorld* world = (LilvWorld*)calloc(1, sizeof(LilvWorld));
 
+	world->node_pool        = lilv_pool_new(sizeof(LilvNode));
+	world->port_pool        = lilv_pool_new(sizeof(LilvPort));
+	world->scale_point_pool = lilv_pool_new(sizeof(LilvScalePoint));
+
 	world->world = sord_world_new();
 	if (!world->world) {
 		goto fail;
@@ -61,20 +156,41 @@ lilv_world_new(void)
 	world->plugin_classes = lilv_plugin_classes_new();
 	world->plugins        = lilv_plugins_new();
 	world->zombies        = lilv_plugins_new();
-	world->loaded_files   = zix_tree_new(
-		false, lilv_resource_node_cmp, NULL, (ZixDestroyFunc)lilv_node_free);
+	world->loaded_files   = lilv_collection_new(
+		lilv_file_uri_cmp, (ZixDestroyFunc)lilv_node_free);
 
 	world->libs = zix_tree_new(false, lilv_lib_compare, NULL, NULL);
 
+	world->bundle_stats = zix_tree_new(
+		false, lilv_bundle_stats_cmp, NULL, lilv_bundle_stats_free);
+
+#ifdef HAVE_PTHREAD
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&world->mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+	pthread_rwlock_init(&world->rwlock, NULL);
+	pthread_key_create(&world->read_depth, NULL);
+	pthread_key_create(&world->write_depth, NULL);
+	pthread_key_create(&world->streams, NULL);
+#endif
+
 #define NS_DCTERMS "http://purl.org/dc/terms/"
 #define NS_DYNMAN  "http://lv2plug.in/ns/ext/dynmanifest#"
 #define NS_OWL     "http://www.w3.org/2002/07/owl#"
 
 #define NEW_URI(uri) sord_new_uri(world->world, (const uint8_t*)(uri))
 
+	world->uris.atom_supports       = NEW_URI(LV2_ATOM__supports);
 	world->uris.dc_replaces         = NEW_URI(NS_DCTERMS   "replaces");
 	world->uris.dman_DynManifest    = NEW_URI(NS_DYNMAN    "DynManifest");
+	world->uris.doap_maintainer     = NEW_URI(LILV_NS_DOAP "maintainer");
 	world->uris.doap_name           = NEW_URI(LILV_NS_DOAP "name");
+	world->uris.ev_supportsEvent    = NEW_URI(LV2_EVENT__supportsEvent);
+	world->uris.foaf_homepage       = NEW_URI(LILV_NS_FOAF "homepage");
+	world->uris.foaf_mbox           = NEW_URI(LILV_NS_FOAF "mbox");
+	world->uris.foaf_name           = NEW_URI(LILV_NS_FOAF "name");
 	world->uris.lv2_Plugin          = NEW_URI(LV2_CORE__Plugin);
 	world->uris.lv2_Specification   = NEW_URI(LV2_CORE__Specification);
 	world->uris.lv2_appliesTo       = NEW_URI(LV2_CORE__appliesTo);
@@ -92,10 +208,12 @@ lilv_world_new(void)
 	world->uris.lv2_optionalFeature = NEW_URI(LV2_CORE__optionalFeature);
 	world->uris.lv2_port            = NEW_URI(LV2_CORE__port);
 	world->uris.lv2_portProperty    = NEW_URI(LV2_CORE__portProperty);
+	world->uris.lv2_project         = NEW_URI(LV2_CORE__project);
 	world->uris.lv2_reportsLatency  = NEW_URI(LV2_CORE__reportsLatency);
 	world->uris.lv2_requiredFeature = NEW_URI(LV2_CORE__requiredFeature);
 	world->uris.lv2_symbol          = NEW_URI(LV2_CORE__symbol);
 	world->uris.lv2_prototype       = NEW_URI(LV2_CORE__prototype);
+	world->uris.lv2_scalePoint      = NEW_URI(LV2_CORE__scalePoint);
 	world->uris.owl_Ontology        = NEW_URI(NS_OWL "Ontology");
 	world->uris.pset_value          = NEW_URI(LV2_PRESETS__value);
 	world->uris.rdf_a               = NEW_URI(LILV_NS_RDF  "type");
@@ -104,6 +222,8 @@ lilv_world_new(void)
 	world->uris.rdfs_label          = NEW_URI(LILV_NS_RDFS "label");
 	world->uris.rdfs_seeAlso        = NEW_URI(LILV_NS_RDFS "seeAlso");
 	world->uris.rdfs_subClassOf     = NEW_URI(LILV_NS_RDFS "subClassOf");
+	world->uris.ui_binary           = NEW_URI(LV2_UI__binary);
+	world->uris.ui_ui               = NEW_URI(LV2_UI__ui);
 	world->uris.xsd_base64Binary    = NEW_URI(LILV_NS_XSD  "base64Binary");
 	world->uris.xsd_boolean         = NEW_URI(LILV_NS_XSD  "boolean");
 	world->uris.xsd_decimal         = NEW_URI(LILV_NS_XSD  "decimal");
@@ -115,13 +235,21 @@ lilv_world_new(void)
 		world, NULL, world->uris.lv2_Plugin, "Plugin");
 	assert(world->lv2_plugin_class);
 
+	world->urid_map = lilv_urid_map_new(world);
+
+	lilv_world_set_lang(world, getenv("LANG"));
+
 	world->n_read_files        = 0;
-	world->opt.filter_language = true;
-	world->opt.dyn_manifest    = true;
+	world->opt.filter_language     = true;
+	world->opt.dyn_manifest        = true;
+	world->opt.lazy_specifications = false;
 
 	return world;
 
 fail:
+	lilv_pool_free(world->scale_point_pool);
+	lilv_pool_free(world->port_pool);
+	lilv_pool_free(world->node_pool);
 	/* keep on rockin' in the */ free(world);
 	return NULL;
 }
@@ -154,24 +282,39 @@ lilv_world_free(LilvWorld* world)
 		const LilvPlugin* p = lilv_plugins_get(world->plugins, i);
 		lilv_plugin_free((LilvPlugin*)p);
 	}
-	zix_tree_free((ZixTree*)world->plugins);
+	lilv_collection_free(world->plugins);
 	world->plugins = NULL;
+	lilv_uri_index_free(&world->plugin_uris);
 
 	LILV_FOREACH(plugins, i, world->zombies) {
 		const LilvPlugin* p = lilv_plugins_get(world->zombies, i);
 		lilv_plugin_free((LilvPlugin*)p);
 	}
-	zix_tree_free((ZixTree*)world->zombies);
+	lilv_collection_free(world->zombies);
 	world->zombies = NULL;
 
-	zix_tree_free((ZixTree*)world->loaded_files);
+	lilv_collection_free(world->loaded_files);
 	world->loaded_files = NULL;
 
 	zix_tree_free(world->libs);
 	world->libs = NULL;
 
-	zix_tree_free((ZixTree*)world->plugin_classes);
+	zix_tree_free(world->bundle_stats);
+	world->bundle_stats = NULL;
+
+	lilv_world_clear_plugin_index(world);
+	lilv_world_clear_label_cache(world);
+	lilv_world_clear_literals(world);
+
+	lilv_query_cache_free(world, world->query_cache);
+	world->query_cache = NULL;
+
+	lilv_urid_map_free(world->urid_map);
+	world->urid_map = NULL;
+
+	lilv_collection_free(world->plugin_classes);
 	world->plugin_classes = NULL;
+	lilv_uri_index_free(&world->class_uris);
 
 	sord_free(world->model);
 	world->model = NULL;
@@ -179,15 +322,165 @@ lilv_world_free(LilvWorld* world)
 	sord_world_free(world->world);
 	world->world = NULL;
 
+	lilv_watch_free(world->watch);
+	world->watch = NULL;
+
+#ifdef HAVE_PTHREAD
+	pthread_key_delete(world->streams);
+	pthread_key_delete(world->write_depth);
+	pthread_key_delete(world->read_depth);
+	pthread_rwlock_destroy(&world->rwlock);
+	pthread_mutex_destroy(&world->mutex);
+#endif
+
+	// Free all nodes, ports, and scale points at once, after their last use
+	lilv_pool_free(world->scale_point_pool);
+	lilv_pool_free(world->port_pool);
+	lilv_pool_free(world->node_pool);
+
+	free(world->lang);
+	free(world->opt.discovery_cache);
 	free(world->opt.lv2_path);
 	free(world);
 }
 
+void
+lilv_world_lock(LilvWorld* world)
+{
+#ifdef HAVE_PTHREAD
+	pthread_mutex_lock(&world->mutex);
+#endif
+}
+
+void
+lilv_world_unlock(LilvWorld* world)
+{
+#ifdef HAVE_PTHREAD
+	pthread_mutex_unlock(&world->mutex);
+#endif
+}
+
+#ifdef HAVE_PTHREAD
+/** Return the number of read locks the calling thread holds on `world`. */
+static uintptr_t
+lilv_world_get_read_depth(const LilvWorld* world)
+{
+	return (uintptr_t)pthread_getspecific(world->read_depth);
+}
+
+/** Return the number of write locks the calling thread holds on `world`. */
+static uintptr_t
+lilv_world_get_write_depth(const LilvWorld* world)
+{
+	return (uintptr_t)pthread_getspecific(world->write_depth);
+}
+#endif
+
+void
+lilv_world_read_lock(LilvWorld* world)
+{
+#ifdef HAVE_PTHREAD
+	// Nothing can change a frozen world, and writers may read as they wish
+	if (world->frozen || lilv_world_get_write_depth(world)) {
+		return;
+	}
+
+	const uintptr_t depth = lilv_world_get_read_depth(world);
+	if (!depth) {
+		pthread_rwlock_rdlock(&world->rwlock);
+	}
+
+	pthread_setspecific(world->read_depth, (void*)(depth + 1));
+#endif
+}
+
+void
+lilv_world_read_unlock(LilvWorld* world)
+{
+#ifdef HAVE_PTHREAD
+	if (world->frozen || lilv_world_get_write_depth(world)) {
+		return;
+	}
+
+	const uintptr_t depth = lilv_world_get_read_depth(world);
+	pthread_setspecific(world->read_depth, (void*)(depth - 1));
+	if (depth == 1) {
+		pthread_rwlock_unlock(&world->rwlock);
+	}
+#endif
+}
+
+void
+lilv_world_write_lock(LilvWorld* world)
+{
+#ifdef HAVE_PTHREAD
+	const uintptr_t depth = lilv_world_get_write_depth(world);
+	if (!depth) {
+		if (lilv_world_get_read_depth(world)) {
+			/* This thread is reading from streams, so stop them and give up
+			   the read lock meanwhile, rather than wait for ourselves. */
+			lilv_world_suspend_streams(world);
+			pthread_rwlock_unlock(&world->rwlock);
+		}
+
+		pthread_rwlock_wrlock(&world->rwlock);
+	}
+
+	pthread_setspecific(world->write_depth, (void*)(depth + 1));
+	pthread_mutex_lock(&world->mutex);
+#endif
+}
+
+void
+lilv_world_write_unlock(LilvWorld* world)
+{
+	/* Cached query results are stale if statements were added or removed.
+	   Other writes, like building plugin classes, do not affect them. */
+	const size_t n_quads = sord_num_quads(world->model);
+	if (n_quads != world->n_quads) {
+		world->n_quads = n_quads;
+		++world->query_generation;
+	}
+
+#ifdef HAVE_PTHREAD
+	const uintptr_t depth = lilv_world_get_write_depth(world);
+
+	pthread_mutex_unlock(&world->mutex);
+	pthread_setspecific(world->write_depth, (void*)(depth - 1));
+	if (depth == 1) {
+		pthread_rwlock_unlock(&world->rwlock);
+		if (lilv_world_get_read_depth(world)) {
+			pthread_rwlock_rdlock(&world->rwlock);  // Streams resume when used
+		}
+	}
+#endif
+}
+
+static void
+lilv_world_set_lang(LilvWorld* world, const char* lang)
+{
+	free(world->lang);
+	world->lang     = lilv_normalize_lang(lang);
+	world->lang_len = world->lang ? strcspn(world->lang, "-") : 0;
+}
+
+const char*
+lilv_world_get_lang(LilvWorld* world, size_t* lang_len)
+{
+	*lang_len = world->lang_len;
+	return world->lang;
+}
+
 void
 lilv_world_set_option(LilvWorld*      world,
                       const char*     uri,
                       const LilvNode* value)
 {
+	if (world->frozen) {
+		LILV_ERROR("World is frozen\n");
+		return;
+	}
+
 	if (!strcmp(uri, LILV_OPTION_DYN_MANIFEST)) {
 		if (lilv_node_is_bool(value)) {
 			world->opt.dyn_manifest = lilv_node_as_bool(value);
@@ -196,6 +489,20 @@ lilv_world_set_option(LilvWorld*      world,
 	} else if (!strcmp(uri, LILV_OPTION_FILTER_LANG)) {
 		if (lilv_node_is_bool(value)) {
 			world->opt.filter_language = lilv_node_as_bool(value);
+			lilv_world_clear_plugin_index(world);
+			++world->generation;
+			++world->query_generation;
+			return;
+		}
+	} else if (!strcmp(uri, LILV_OPTION_LANG)) {
+		if (!value || lilv_node_is_string(value)) {
+			// No value means to read LANG again
+			lilv_world_set_lang(world,
+			                    value ? lilv_node_as_string(value)
+			                          : getenv("LANG"));
+			lilv_world_clear_plugin_index(world);
+			++world->generation;
+			++world->query_generation;
 			return;
 		}
 	} else if (!strcmp(uri, LILV_OPTION_LV2_PATH)) {
@@ -203,36 +510,98 @@ lilv_world_set_option(LilvWorld*      world,
 			world->opt.lv2_path = lilv_strdup(lilv_node_as_string(value));
 			return;
 		}
+	} else if (!strcmp(uri, LILV_OPTION_LOAD_THREADS)) {
+		if (lilv_node_is_int(value) && lilv_node_as_int(value) >= 0) {
+			world->opt.load_threads = (unsigned)lilv_node_as_int(value);
+			return;
+		}
+	} else if (!strcmp(uri, LILV_OPTION_LAZY_SPECIFICATIONS)) {
+		if (lilv_node_is_bool(value)) {
+			world->opt.lazy_specifications = lilv_node_as_bool(value);
+			return;
+		}
+	} else if (!strcmp(uri, LILV_OPTION_QUERY_CACHE_SIZE)) {
+		if (lilv_node_is_int(value) && lilv_node_as_int(value) >= 0) {
+			const int size = lilv_node_as_int(value);
+			lilv_query_cache_free(world, world->query_cache);
+			world->query_cache =
+				size ? lilv_query_cache_new((unsigned)size) : NULL;
+			return;
+		}
+	} else if (!strcmp(uri, LILV_OPTION_DISCOVERY_CACHE)) {
+		if (lilv_node_is_string(value)) {
+			free(world->opt.discovery_cache);
+			world->opt.discovery_cache =
+				lilv_strdup(lilv_node_as_string(value));
+			return;
+		}
 	}
 	LILV_WARNF("Unrecognized or invalid option `%s'\n", uri);
 }
 
-LilvNodes*
-lilv_world_find_nodes(LilvWorld*      world,
-                      const LilvNode* subject,
-                      const LilvNode* predicate,
-                      const LilvNode* object)
+/** Return true if a pattern is valid for lilv_world_find_nodes(). */
+static bool
+lilv_world_check_pattern(const LilvNode* subject,
+                         const LilvNode* predicate,
+                         const LilvNode* object)
 {
 	if (subject && !lilv_node_is_uri(subject) && !lilv_node_is_blank(subject)) {
 		LILV_ERRORF("Subject `%s' is not a resource\n",
 		            sord_node_get_string(subject->node));
-		return NULL;
+		return false;
 	} else if (!predicate) {
 		LILV_ERROR("Missing required predicate\n");
-		return NULL;
+		return false;
 	} else if (!lilv_node_is_uri(predicate)) {
 		LILV_ERRORF("Predicate `%s' is not a URI\n",
 		            sord_node_get_string(predicate->node));
-		return NULL;
+		return false;
 	} else if (!subject && !object) {
 		LILV_ERROR("Both subject and object are NULL\n");
+		return false;
+	}
+
+	return true;
+}
+
+LilvNodes*
+lilv_world_find_nodes(LilvWorld*      world,
+                      const LilvNode* subject,
+                      const LilvNode* predicate,
+                      const LilvNode* object)
+{
+	if (!lilv_world_check_pattern(subject, predicate, object)) {
+		return NULL;
+	}
+
+	lilv_world_load_namespace(world, subject ? subject->node : NULL);
+	lilv_world_load_namespace(world, predicate->node);
+
+	return lilv_world_find_nodes_cached(world,
+	                                    subject ? subject->node : NULL,
+	                                    predicate->node,
+	                                    object ? object->node : NULL,
+	                                    false);
+}
+
+LilvMatches*
+lilv_world_find_matches(LilvWorld*      world,
+                        const LilvNode* subject,
+                        const LilvNode* predicate,
+                        const LilvNode* object)
+{
+	if (!lilv_world_check_pattern(subject, predicate, object)) {
 		return NULL;
 	}
 
-	return lilv_world_find_nodes_internal(world,
-	                                      subject ? subject->node : NULL,
-	                                      predicate->node,
-	                                      object ? object->node : NULL);
+	lilv_world_load_namespace(world, subject ? subject->node : NULL);
+	lilv_world_load_namespace(world, predicate->node);
+
+	return lilv_matches_new(world,
+	                        subject ? subject->node : NULL,
+	                        predicate->node,
+	                        object ? object->node : NULL,
+	                        (object == NULL) ? SORD_OBJECT : SORD_SUBJECT);
 }
 
 LilvNode*
@@ -241,16 +610,16 @@ lilv_world_get(LilvWorld*      world,
                const LilvNode* predicate,
                const LilvNode* object)
 {
-	if (!object) {
-		// TODO: Improve performance (see lilv_plugin_get_one)
-		SordIter* stream = sord_search(world->model,
-		                               subject   ? subject->node : NULL,
-		                               predicate ? predicate->node : NULL,
-		                               NULL,
-		                               NULL);
+	lilv_world_load_namespace(world, subject ? subject->node : NULL);
+	lilv_world_load_namespace(world, predicate ? predicate->node : NULL);
 
-		LilvNodes* nodes =
-		    lilv_nodes_from_stream_objects(world, stream, SORD_OBJECT);
+	if (!object) {
+		LilvNodes* nodes = lilv_world_find_nodes_cached(
+			world,
+			subject   ? subject->node : NULL,
+			predicate ? predicate->node : NULL,
+			NULL,
+			true);
 
 		if (nodes) {
 			LilvNode* value = lilv_node_duplicate(lilv_nodes_get_first(nodes));
@@ -261,6 +630,8 @@ lilv_world_get(LilvWorld*      world,
 		return NULL;
 	}
 
+	lilv_world_read_lock(world);
+	lilv_world_lock(world);
 	SordNode* snode = sord_get(world->model,
 	                           subject   ? subject->node   : NULL,
 	                           predicate ? predicate->node : NULL,
@@ -268,6 +639,8 @@ lilv_world_get(LilvWorld*      world,
 	                           NULL);
 	LilvNode* lnode = lilv_node_new_from_node(world, snode);
 	sord_node_free(world->world, snode);
+	lilv_world_unlock(world);
+	lilv_world_read_unlock(world);
 	return lnode;
 }
 
@@ -277,7 +650,21 @@ lilv_world_query_internal(LilvWorld*      world,
                           const SordNode* predicate,
                           const SordNode* object)
 {
-	return sord_search(world->model, subject, predicate, object, NULL);
+	lilv_world_read_lock(world);
+	lilv_world_lock(world);
+	SordIter* iter = sord_search(world->model, subject, predicate, object, NULL);
+	++world->stats.n_searches;
+	lilv_world_unlock(world);
+	return iter;
+}
+
+void
+lilv_world_iter_free(LilvWorld* world, SordIter* iter)
+{
+	lilv_world_lock(world);
+	sord_iter_free(iter);
+	lilv_world_unlock(world);
+	lilv_world_read_unlock(world);
 }
 
 bool
@@ -286,7 +673,12 @@ lilv_world_ask_internal(LilvWorld*      world,
                         const SordNode* predicate,
                         const SordNode* object)
 {
-	return sord_ask(world->model, subject, predicate, object, NULL);
+	lilv_world_read_lock(world);
+	lilv_world_lock(world);
+	const bool ret = sord_ask(world->model, subject, predicate, object, NULL);
+	lilv_world_unlock(world);
+	lilv_world_read_unlock(world);
+	return ret;
 }
 
 bool
@@ -295,11 +687,13 @@ lilv_world_ask(LilvWorld*      world,
                const LilvNode* predicate,
                const LilvNode* object)
 {
-	return sord_ask(world->model,
-	                subject   ? subject->node   : NULL,
-	                predicate ? predicate->node : NULL,
-	                object    ? object->node    : NULL,
-	                NULL);
+	lilv_world_load_namespace(world, subject ? subject->node : NULL);
+	lilv_world_load_namespace(world, predicate ? predicate->node : NULL);
+
+	return lilv_world_ask_cached(world,
+	                             subject   ? subject->node   : NULL,
+	                             predicate ? predicate->node : NULL,
+	                             object    ? object->node    : NULL);
 }
 
 SordModel*
@@ -345,9 +739,11 @@ lilv_new_uri_relative_to_base(const uint8_t* uri_str,
 const uint8_t*
 lilv_world_blank_node_prefix(LilvWorld* world)
 {
-	static char str[32];
-	snprintf(str, sizeof(str), "%u", world->n_read_files++);
-	return (const uint8_t*)str;
+	snprintf(world->blank_prefix,
+	         sizeof(world->blank_prefix),
+	         "%u",
+	         world->n_read_files++);
+	return (const uint8_t*)world->blank_prefix;
 }
 
 /** Comparator for sequences (e.g. world->plugins). */
@@ -356,6 +752,10 @@ lilv_header_compare_by_uri(const void* a, const void* b, void* user_data)
 {
 	const struct LilvHeader* const header_a = (const struct LilvHeader*)a;
 	const struct LilvHeader* const header_b = (const struct LilvHeader*)b;
+	if (header_a->uri->node == header_b->uri->node) {
+		return 0;  // Same interned node, so the same URI
+	}
+
 	return strcmp(lilv_node_as_uri(header_a->uri),
 	              lilv_node_as_uri(header_b->uri));
 }
@@ -378,24 +778,39 @@ lilv_lib_compare(const void* a, const void* b, void* user_data)
 }
 
 /** Get an element of a collection of any object with an LilvHeader by URI. */
-static ZixTreeIter*
-lilv_collection_find_by_uri(const ZixTree* seq, const LilvNode* uri)
+static LilvIter*
+lilv_collection_find_by_uri(const LilvCollection* seq, const LilvNode* uri)
 {
-	ZixTreeIter* i = NULL;
 	if (lilv_node_is_uri(uri)) {
 		struct LilvHeader key = { NULL, (LilvNode*)uri };
-		zix_tree_find(seq, &key, &i);
+		return lilv_collection_find(seq, &key);
 	}
-	return i;
+	return NULL;
 }
 
-/** Get an element of a collection of any object with an LilvHeader by URI. */
+/**
+   Get an element of a collection of any object with an LilvHeader by URI.
+
+   The plugins and plugin classes of the world are found by interned node in
+   a hash table, other collections are searched by URI string.
+*/
 struct LilvHeader*
-lilv_collection_get_by_uri(const ZixTree* seq, const LilvNode* uri)
+lilv_collection_get_by_uri(const LilvCollection* seq, const LilvNode* uri)
 {
-	ZixTreeIter* const i = lilv_collection_find_by_uri(seq, uri);
+	if (!lilv_node_is_uri(uri)) {
+		return NULL;
+	}
 
-	return i ? (struct LilvHeader*)zix_tree_get(i) : NULL;
+	const LilvWorld* const world = uri->world;
+	if (seq == world->plugins) {
+		return lilv_uri_index_get(&world->plugin_uris, uri->node);
+	} else if (seq == world->plugin_classes) {
+		return lilv_uri_index_get(&world->class_uris, uri->node);
+	}
+
+	LilvIter* const i = lilv_collection_find_by_uri(seq, uri);
+
+	return (struct LilvHeader*)lilv_collection_get(seq, i);
 }
 
 static void
@@ -407,6 +822,7 @@ lilv_world_add_spec(LilvWorld*      world,
 	spec->spec      = sord_node_copy(specification_node);
 	spec->bundle    = sord_node_copy(bundle_node);
 	spec->data_uris = lilv_nodes_new();
+	spec->loaded    = false;
 
 	// Add all data files (rdfs:seeAlso)
 	SordIter* files = sord_search(world->model,
@@ -416,9 +832,8 @@ lilv_world_add_spec(LilvWorld*      world,
 	                              NULL);
 	FOREACH_MATCH(files) {
 		const SordNode* file_node = sord_iter_get_node(files, SORD_OBJECT);
-		zix_tree_insert((ZixTree*)spec->data_uris,
-		                lilv_node_new_from_node(world, file_node),
-		                NULL);
+		lilv_collection_insert(spec->data_uris,
+		                       lilv_node_new_from_node(world, file_node));
 	}
 	sord_iter_free(files);
 
@@ -427,18 +842,21 @@ lilv_world_add_spec(LilvWorld*      world,
 	world->specs = spec;
 }
 
-static void
+/** Add a plugin, returning it, or NULL if it is a duplicate to be ignored. */
+static LilvPlugin*
 lilv_world_add_plugin(LilvWorld*      world,
                       const SordNode* plugin_node,
                       const LilvNode* manifest_uri,
                       void*           dynmanifest,
                       const SordNode* bundle)
 {
-	LilvNode*    plugin_uri = lilv_node_new_from_node(world, plugin_node);
-	ZixTreeIter* z          = NULL;
-	LilvPlugin*  plugin     = (LilvPlugin*)lilv_plugins_get_by_uri(
+	LilvNode*   plugin_uri = lilv_node_new_from_node(world, plugin_node);
+	LilvIter*   z          = NULL;
+	LilvPlugin* plugin     = (LilvPlugin*)lilv_plugins_get_by_uri(
 		world->plugins, plugin_uri);
 
+	lilv_world_clear_plugin_index(world);
+
 	if (plugin) {
 		// Existing plugin, if this is different bundle, ignore it
 		// (use the first plugin found in LV2_PATH)
@@ -446,21 +864,22 @@ lilv_world_add_plugin(LilvWorld*      world,
 		const char*     plugin_uri_str = lilv_node_as_uri(plugin_uri);
 		if (sord_node_equals(bundle, last_bundle->node)) {
 			LILV_WARNF("Reloading plugin <%s>\n", plugin_uri_str);
-			plugin->loaded = false;
+			plugin->loaded        = false;
+			plugin->version_known = false;
 			lilv_node_free(plugin_uri);
 		} else {
 			LILV_WARNF("Duplicate plugin <%s>\n", plugin_uri_str);
 			LILV_WARNF("... found in %s\n", lilv_node_as_string(last_bundle));
 			LILV_WARNF("... and      %s (ignored)\n", sord_node_get_string(bundle));
 			lilv_node_free(plugin_uri);
-			return;
+			return NULL;
 		}
-	} else if ((z = lilv_collection_find_by_uri((const ZixTree*)world->zombies,
-	                                            plugin_uri))) {
+	} else if ((z = lilv_collection_find_by_uri(world->zombies, plugin_uri))) {
 		// Plugin bundle has been re-loaded, move from zombies to plugins
-		plugin = (LilvPlugin*)zix_tree_get(z);
-		zix_tree_remove((ZixTree*)world->zombies, z);
-		zix_tree_insert((ZixTree*)world->plugins, plugin, NULL);
+		plugin = (LilvPlugin*)lilv_collection_get(world->zombies, z);
+		lilv_collection_remove(world->zombies, z);
+		lilv_collection_insert(world->plugins, plugin);
+		lilv_uri_index_insert(&world->plugin_uris, (struct LilvHeader*)plugin);
 		lilv_node_free(plugin_uri);
 		lilv_plugin_clear(plugin, lilv_node_new_from_node(world, bundle));
 	} else {
@@ -469,12 +888,12 @@ lilv_world_add_plugin(LilvWorld*      world,
 			world, plugin_uri, lilv_node_new_from_node(world, bundle));
 
 		// Add manifest as plugin data file (as if it were rdfs:seeAlso)
-		zix_tree_insert((ZixTree*)plugin->data_uris,
-		                lilv_node_duplicate(manifest_uri),
-		                NULL);
+		lilv_collection_insert(plugin->data_uris,
+		                       lilv_node_duplicate(manifest_uri));
 
 		// Add plugin to world plugin sequence
-		zix_tree_insert((ZixTree*)world->plugins, plugin, NULL);
+		lilv_collection_insert(world->plugins, plugin);
+		lilv_uri_index_insert(&world->plugin_uris, (struct LilvHeader*)plugin);
 	}
 
 
@@ -494,11 +913,12 @@ lilv_world_add_plugin(LilvWorld*      world,
 	                              NULL);
 	FOREACH_MATCH(files) {
 		const SordNode* file_node = sord_iter_get_node(files, SORD_OBJECT);
-		zix_tree_insert((ZixTree*)plugin->data_uris,
-		                lilv_node_new_from_node(world, file_node),
-		                NULL);
+		lilv_collection_insert(plugin->data_uris,
+		                       lilv_node_new_from_node(world, file_node));
 	}
 	sord_iter_free(files);
+
+	return plugin;
 }
 
 SerdStatus
@@ -679,55 +1099,92 @@ lilv_world_get_manifest_uri(LilvWorld* world, const LilvNode* bundle_uri)
 	return manifest;
 }
 
-static SordModel*
-load_plugin_model(LilvWorld*      world,
-                  const LilvNode* bundle_uri,
-                  const LilvNode* plugin_uri)
+/** Data read from a bundle to compare plugin versions. */
+typedef struct {
+	SordModel*  model;    ///< Manifest and data of any loaded plugins
+	SerdEnv*    env;      ///< Environment for reader
+	SerdReader* reader;   ///< Reader into model
+	LilvNodes*  files;    ///< Data files already read into model
+	LilvNodes*  plugins;  ///< Plugins with all data read into model
+} LilvBundleModel;
+
+static void
+lilv_bundle_model_init(LilvWorld*       world,
+                       LilvBundleModel* data,
+                       const LilvNode*  bundle_uri)
 {
 	// Create model and reader for loading into it
-	SordNode*   bundle_node = bundle_uri->node;
-	SordModel*  model       = sord_new(world->world, SORD_SPO|SORD_OPS, false);
-	SerdEnv*    env         = serd_env_new(sord_node_to_serd_node(bundle_node));
-	SerdReader* reader      = sord_new_reader(model, env, SERD_TURTLE, NULL);
+	SordNode* bundle_node = bundle_uri->node;
+	data->model   = sord_new(world->world, SORD_SPO|SORD_OPS, false);
+	data->env     = serd_env_new(sord_node_to_serd_node(bundle_node));
+	data->reader  = sord_new_reader(data->model, data->env, SERD_TURTLE, NULL);
+	data->files   = lilv_nodes_new();
+	data->plugins = lilv_nodes_new();
 
 	// Load manifest
 	LilvNode* manifest_uri = lilv_world_get_manifest_uri(world, bundle_uri);
-	serd_reader_add_blank_prefix(reader, lilv_world_blank_node_prefix(world));
+	serd_reader_add_blank_prefix(data->reader,
+	                             lilv_world_blank_node_prefix(world));
 	serd_reader_read_file(
-		reader, (const uint8_t*)lilv_node_as_string(manifest_uri));
+		data->reader, (const uint8_t*)lilv_node_as_string(manifest_uri));
+	lilv_node_free(manifest_uri);
+}
+
+/** Load any seeAlso files of `plugin` that have not already been loaded. */
+static void
+lilv_bundle_model_load_plugin(LilvWorld*       world,
+                              LilvBundleModel* data,
+                              const SordNode*  plugin)
+{
+	LilvNode* plugin_uri = lilv_node_new_from_node(world, plugin);
+	if (lilv_collection_insert(data->plugins, plugin_uri)) {
+		lilv_node_free(plugin_uri);
+		return;
+	}
 
-	// Load any seeAlso files
 	SordModel* files = lilv_world_filter_model(
-		world, model, plugin_uri->node, world->uris.rdfs_seeAlso, NULL, NULL);
+		world, data->model, plugin, world->uris.rdfs_seeAlso, NULL, NULL);
 
 	SordIter* f = sord_begin(files);
 	FOREACH_MATCH(f) {
-		const SordNode* file      = sord_iter_get_node(f, SORD_OBJECT);
-		const uint8_t*  file_str  = sord_node_get_string(file);
-		if (sord_node_get_type(file) == SORD_URI) {
+		const SordNode* file     = sord_iter_get_node(f, SORD_OBJECT);
+		const uint8_t*  file_str = sord_node_get_string(file);
+		LilvNode*       file_uri = lilv_node_new_from_node(world, file);
+		if (sord_node_get_type(file) == SORD_URI &&
+		    !lilv_collection_insert(data->files, file_uri)) {
 			serd_reader_add_blank_prefix(
-				reader, lilv_world_blank_node_prefix(world));
-			serd_reader_read_file(reader, file_str);
+				data->reader, lilv_world_blank_node_prefix(world));
+			serd_reader_read_file(data->reader, file_str);
+		} else {
+			lilv_node_free(file_uri);
 		}
 	}
 
 	sord_iter_free(f);
 	sord_free(files);
-	serd_reader_free(reader);
-	serd_env_free(env);
-	lilv_node_free(manifest_uri);
-
-	return model;
 }
 
-static LilvVersion
-get_version(LilvWorld* world, SordModel* model, const LilvNode* subject)
+static void
+lilv_bundle_model_free(LilvBundleModel* data)
 {
-	const SordNode* minor_node = sord_get(
-		model, subject->node, world->uris.lv2_minorVersion, NULL, NULL);
-	const SordNode* micro_node = sord_get(
-		model, subject->node, world->uris.lv2_microVersion, NULL, NULL);
+	if (data->model) {
+		lilv_nodes_free(data->plugins);
+		lilv_nodes_free(data->files);
+		serd_reader_free(data->reader);
+		serd_env_free(data->env);
+		sord_free(data->model);
+	}
+}
 
+LilvVersion
+lilv_world_get_version(LilvWorld*      world,
+                       SordModel*      model,
+                       const SordNode* subject)
+{
+	SordNode* minor_node = sord_get(
+		model, subject, world->uris.lv2_minorVersion, NULL, NULL);
+	SordNode* micro_node = sord_get(
+		model, subject, world->uris.lv2_microVersion, NULL, NULL);
 
 	LilvVersion version = { 0, 0 };
 	if (minor_node && micro_node) {
@@ -735,28 +1192,49 @@ get_version(LilvWorld* world, SordModel* model, const LilvNode* subject)
 		version.micro = atoi((const char*)sord_node_get_string(micro_node));
 	}
 
+	sord_node_free(world->world, minor_node);
+	sord_node_free(world->world, micro_node);
 	return version;
 }
 
-void
-lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+/**
+   Return the version of a plugin in the world.
+
+   This is only read from disk if it was not recorded when the plugin was
+   added or loaded, and is then remembered until the plugin is reloaded.
+*/
+static LilvVersion
+lilv_world_get_plugin_version(LilvWorld* world, LilvPlugin* plugin)
 {
-	if (!lilv_node_is_uri(bundle_uri)) {
-		LILV_ERRORF("Bundle URI `%s' is not a URI\n",
-		            sord_node_get_string(bundle_uri->node));
-		return;
+	if (!plugin->version_known) {
+		LilvBundleModel data;
+		lilv_bundle_model_init(world, &data, plugin->bundle_uri);
+		lilv_bundle_model_load_plugin(world, &data, plugin->plugin_uri->node);
+
+		plugin->version = lilv_world_get_version(
+			world, data.model, plugin->plugin_uri->node);
+		plugin->version_known = true;
+
+		lilv_bundle_model_free(&data);
 	}
 
+	return plugin->version;
+}
+
+/**
+   Add the plugins and specifications described by a bundle manifest.
+
+   The manifest must already be loaded into the model with graph `bundle_uri`.
+*/
+static void
+lilv_world_add_bundle(LilvWorld*      world,
+                      const LilvNode* bundle_uri,
+                      const LilvNode* manifest)
+{
 	SordNode* bundle_node = bundle_uri->node;
-	LilvNode* manifest    = lilv_world_get_manifest_uri(world, bundle_uri);
 
-	// Read manifest into model with graph = bundle_node
-	SerdStatus st = lilv_world_load_graph(world, bundle_node, manifest);
-	if (st > SERD_FAILURE) {
-		LILV_ERRORF("Error reading %s\n", lilv_node_as_string(manifest));
-		lilv_node_free(manifest);
-		return;
-	}
+	// Remembered names may now differ, so forget them at the next query
+	++world->generation;
 
 	// ?plugin a lv2:Plugin
 	SordIter* plug_results = sord_search(world->model,
@@ -766,31 +1244,36 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 	                                     bundle_node);
 
 	// Find any loaded plugins that will be replaced with a newer version
-	LilvNodes* unload_uris = lilv_nodes_new();
+	LilvNodes*      unload_uris = lilv_nodes_new();
+	LilvBundleModel data        = { NULL, NULL, NULL, NULL, NULL };
 	FOREACH_MATCH(plug_results) {
 		const SordNode* plug = sord_iter_get_node(plug_results, SORD_SUBJECT);
 
-		LilvNode*         plugin_uri  = lilv_node_new_from_node(world, plug);
-		const LilvPlugin* plugin      = lilv_plugins_get_by_uri(world->plugins, plugin_uri);
-		const LilvNode*   last_bundle = plugin ? lilv_plugin_get_bundle_uri(plugin) : NULL;
+		LilvNode*       plugin_uri  = lilv_node_new_from_node(world, plug);
+		LilvPlugin*     plugin      = (LilvPlugin*)lilv_plugins_get_by_uri(
+			world->plugins, plugin_uri);
+		const LilvNode* last_bundle = plugin ? lilv_plugin_get_bundle_uri(plugin) : NULL;
 		if (!plugin || sord_node_equals(bundle_node, last_bundle->node)) {
 			// No previously loaded version, or it's from the same bundle
 			lilv_node_free(plugin_uri);
 			continue;
 		}
 
-		// Compare versions
-		SordModel*  this_model   = load_plugin_model(world, bundle_uri, plugin_uri);
-		LilvVersion this_version = get_version(world, this_model, plugin_uri);
-		SordModel*  last_model   = load_plugin_model(world, last_bundle, plugin_uri);
-		LilvVersion last_version = get_version(world, last_model, plugin_uri);
-		sord_free(this_model);
-		sord_free(last_model);
+		// Compare versions, reading this bundle at most once
+		if (!data.model) {
+			lilv_bundle_model_init(world, &data, bundle_uri);
+		}
+		lilv_bundle_model_load_plugin(world, &data, plug);
+
+		const LilvVersion this_version =
+			lilv_world_get_version(world, data.model, plug);
+		const LilvVersion last_version =
+			lilv_world_get_plugin_version(world, plugin);
+
 		const int cmp = lilv_version_cmp(&this_version, &last_version);
 		if (cmp > 0) {
-			zix_tree_insert((ZixTree*)unload_uris,
-			                lilv_node_duplicate(plugin_uri),
-			                NULL);
+			lilv_collection_insert(unload_uris,
+			                       lilv_node_duplicate(plugin_uri));
 			LILV_WARNF("Replacing version %d.%d of <%s> from <%s>\n",
 			           last_version.minor, last_version.micro,
 			           sord_node_get_string(plug),
@@ -807,8 +1290,8 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 			lilv_node_free(plugin_uri);
 			sord_iter_free(plug_results);
 			lilv_world_drop_graph(world, bundle_node);
-			lilv_node_free(manifest);
 			lilv_nodes_free(unload_uris);
+			lilv_bundle_model_free(&data);
 			return;
 		}
 		lilv_node_free(plugin_uri);
@@ -825,9 +1308,7 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 
 		// Unload plugin and record bundle for later unloading
 		lilv_world_unload_resource(world, uri);
-		zix_tree_insert((ZixTree*)unload_bundles,
-		                lilv_node_duplicate(bundle),
-		                NULL);
+		lilv_collection_insert(unload_bundles, lilv_node_duplicate(bundle));
 
 	}
 	lilv_nodes_free(unload_uris);
@@ -847,10 +1328,19 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 	                           bundle_node);
 
 	FOREACH_MATCH(plug_results) {
-		const SordNode* plug = sord_iter_get_node(plug_results, SORD_SUBJECT);
-		lilv_world_add_plugin(world, plug, manifest, NULL, bundle_node);
+		const SordNode* plug   = sord_iter_get_node(plug_results, SORD_SUBJECT);
+		LilvPlugin*     plugin = lilv_world_add_plugin(
+			world, plug, manifest, NULL, bundle_node);
+
+		if (plugin && data.model && !plugin->version_known &&
+		    lilv_collection_find(data.plugins, plugin->plugin_uri)) {
+			// Remember the version read to compare with the previous one
+			plugin->version = lilv_world_get_version(world, data.model, plug);
+			plugin->version_known = true;
+		}
 	}
 	sord_iter_free(plug_results);
+	lilv_bundle_model_free(&data);
 
 	lilv_world_load_dyn_manifest(world, bundle_node, manifest);
 
@@ -868,19 +1358,84 @@ lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 		}
 		sord_iter_free(i);
 	}
+}
 
+void
+lilv_world_load_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+{
+	if (world->frozen) {
+		LILV_ERROR("World is frozen\n");
+		return;
+	}
+
+	if (!lilv_node_is_uri(bundle_uri)) {
+		LILV_ERRORF("Bundle URI `%s' is not a URI\n",
+		            sord_node_get_string(bundle_uri->node));
+		return;
+	}
+
+	SordNode* bundle_node = bundle_uri->node;
+	LilvNode* manifest    = lilv_world_get_manifest_uri(world, bundle_uri);
+
+	lilv_world_write_lock(world);
+	lilv_world_add_bundle_stats(world, bundle_uri);
+
+	// Read manifest into model with graph = bundle_node
+	SerdStatus st = lilv_world_load_graph(world, bundle_node, manifest);
+	if (st > SERD_FAILURE) {
+		LILV_ERRORF("Error reading %s\n", lilv_node_as_string(manifest));
+	} else {
+		if (world->cache && !st) {
+			// Record manifest statements before anything else is added
+			lilv_cache_capture_bundle(world->cache, bundle_node);
+		}
+
+		lilv_world_add_bundle(world, bundle_uri, manifest);
+	}
+
+	lilv_world_write_unlock(world);
 	lilv_node_free(manifest);
 }
 
+/**
+   Load a bundle from the discovery cache.
+
+   The bundle must have been found to be unchanged with
+   lilv_cache_check_bundle().
+
+   @return True if the bundle was restored from the cache, otherwise it must
+   be loaded from disk.
+*/
+static bool
+lilv_world_restore_bundle(LilvWorld* world, const LilvNode* bundle_uri)
+{
+	LilvNode* manifest = lilv_world_get_manifest_uri(world, bundle_uri);
+	if (lilv_collection_find(world->loaded_files, manifest)) {
+		lilv_node_free(manifest);
+		return false;  // Already loaded, let lilv_world_load_bundle() handle it
+	}
+
+	// Add cached statements as if the manifest was read from disk
+	lilv_world_add_bundle_stats(world, bundle_uri);
+	lilv_cache_restore_bundle(world->cache, bundle_uri->node);
+	lilv_collection_insert(world->loaded_files, lilv_node_duplicate(manifest));
+
+	lilv_world_add_bundle(world, bundle_uri, manifest);
+	lilv_node_free(manifest);
+	return true;
+}
+
 static int
 lilv_world_drop_graph(LilvWorld* world, const SordNode* graph)
 {
+	// Searching with only the graph bound uses the graph index
 	SordIter* i = sord_search(world->model, NULL, NULL, NULL, graph);
 	while (!sord_iter_end(i)) {
 		const SerdStatus st = sord_erase(world->model, i);
 		if (st) {
 			LILV_ERRORF("Error removing statement from <%s> (%s)\n",
 			            sord_node_get_string(graph), serd_strerror(st));
+			sord_iter_free(i);
 			return st;
 		}
 	}
@@ -893,9 +1448,9 @@ lilv_world_drop_graph(LilvWorld* world, const SordNode* graph)
 static int
 lilv_world_unload_file(LilvWorld* world, const LilvNode* file)
 {
-	ZixTreeIter* iter = NULL;
-	if (!zix_tree_find((ZixTree*)world->loaded_files, file, &iter)) {
-		zix_tree_remove((ZixTree*)world->loaded_files, iter);
+	LilvIter* const iter = lilv_collection_find(world->loaded_files, file);
+	if (iter) {
+		lilv_collection_remove(world->loaded_files, iter);
 		return 0;
 	}
 	return 1;
@@ -904,52 +1459,98 @@ lilv_world_unload_file(LilvWorld* world, const LilvNode* file)
 int
 lilv_world_unload_bundle(LilvWorld* world, const LilvNode* bundle_uri)
 {
+	if (world->frozen) {
+		LILV_ERROR("World is frozen\n");
+		return -1;
+	}
+
 	if (!bundle_uri) {
 		return 0;
 	}
 
-	// Find all loaded files that are inside the bundle
-	LilvNodes* files = lilv_nodes_new();
-	LILV_FOREACH(nodes, i, world->loaded_files) {
-		const LilvNode* file = lilv_nodes_get(world->loaded_files, i);
-		if (!strncmp(lilv_node_as_string(file),
-		             lilv_node_as_string(bundle_uri),
-		             strlen(lilv_node_as_string(bundle_uri)))) {
-			zix_tree_insert((ZixTree*)files,
-			                lilv_node_duplicate(file),
-			                NULL);
+	lilv_world_write_lock(world);
+
+	// Unload all loaded files in the bundle, which are adjacent by URI
+	const char* const bundle_str = lilv_node_as_string(bundle_uri);
+	const size_t      bundle_len = strlen(bundle_str);
+	LilvIter*         f          =
+		lilv_collection_lower_bound(world->loaded_files, bundle_uri);
+	while (!lilv_collection_is_end(world->loaded_files, f)) {
+		const LilvNode* file =
+			(const LilvNode*)lilv_collection_get(world->loaded_files, f);
+		if (strncmp(lilv_node_as_string(file), bundle_str, bundle_len)) {
+			break;
 		}
-	}
 
-	// Unload all loaded files in the bundle
-	LILV_FOREACH(nodes, i, files) {
-		const LilvNode* file = lilv_nodes_get(world->plugins, i);
-		lilv_world_unload_file(world, file);
+		lilv_collection_remove(world->loaded_files, f);  // f is now the next
 	}
 
-	lilv_nodes_free(files);
-
 	/* Remove any plugins in the bundle from the plugin list.  Since the
 	   application may still have a pointer to the LilvPlugin, it can not be
 	   destroyed here.  Instead, we move it to the zombie plugin list, so it
 	   will not be in the list returned by lilv_world_get_all_plugins() but can
 	   still be used.
+
+	   The plugins are found by searching the bundle graph for ?plugin a
+	   lv2:Plugin, which, like dropping the graph, uses the graph index so
+	   the cost is proportional to the size of the bundle.
 	*/
-	ZixTreeIter* i = zix_tree_begin((ZixTree*)world->plugins);
-	while (i != zix_tree_end((ZixTree*)world->plugins)) {
-		LilvPlugin*  p    = (LilvPlugin*)zix_tree_get(i);
-		ZixTreeIter* next = zix_tree_iter_next(i);
-
-		if (lilv_node_equals(lilv_plugin_get_bundle_uri(p), bundle_uri)) {
-			zix_tree_remove((ZixTree*)world->plugins, i);
-			zix_tree_insert((ZixTree*)world->zombies, p, NULL);
+	LilvNodes* plugin_uris = lilv_nodes_new();
+	SordIter*  p           = sord_search(world->model,
+	                                     NULL,
+	                                     world->uris.rdf_a,
+	                                     world->uris.lv2_Plugin,
+	                                     bundle_uri->node);
+	FOREACH_MATCH(p) {
+		const SordNode* plug = sord_iter_get_node(p, SORD_SUBJECT);
+		lilv_collection_insert(plugin_uris,
+		                       lilv_node_new_from_node(world, plug));
+	}
+	sord_iter_free(p);
+
+	LILV_FOREACH(nodes, i, plugin_uris) {
+		const LilvNode* uri = lilv_nodes_get(plugin_uris, i);
+		LilvIter* const z   = lilv_collection_find_by_uri(world->plugins, uri);
+		if (z) {
+			LilvPlugin* plugin =
+				(LilvPlugin*)lilv_collection_get(world->plugins, z);
+			if (lilv_node_equals(lilv_plugin_get_bundle_uri(plugin),
+			                     bundle_uri)) {
+				lilv_uri_index_remove(&world->plugin_uris,
+				                      (struct LilvHeader*)plugin);
+				lilv_collection_remove(world->plugins, z);
+				lilv_collection_insert(world->zombies, plugin);
+			}
 		}
+	}
+	lilv_nodes_free(plugin_uris);
 
-		i = next;
+#ifdef LILV_DYN_MANIFEST
+	// Plugins from dynamic manifests are not described in the bundle graph
+	LilvIter* d = lilv_collection_begin(world->plugins);
+	while (!lilv_collection_is_end(world->plugins, d)) {
+		LilvPlugin* plugin = (LilvPlugin*)lilv_collection_get(world->plugins, d);
+		if (plugin->dynmanifest &&
+		    lilv_node_equals(lilv_plugin_get_bundle_uri(plugin), bundle_uri)) {
+			lilv_uri_index_remove(&world->plugin_uris,
+			                      (struct LilvHeader*)plugin);
+			lilv_collection_remove(world->plugins, d);  // d is now the next
+			lilv_collection_insert(world->zombies, plugin);
+		} else {
+			d = lilv_collection_next(world->plugins, d);
+		}
 	}
+#endif
+
+	lilv_world_clear_plugin_index(world);
+	lilv_world_clear_literals(world);
+	++world->generation;
 
 	// Drop everything in bundle graph
-	return lilv_world_drop_graph(world, bundle_uri->node);
+	const int st = lilv_world_drop_graph(world, bundle_uri->node);
+
+	lilv_world_write_unlock(world);
+	return st;
 }
 
 static void
@@ -960,23 +1561,17 @@ load_dir_entry(const char* dir, const char* name, void* data)
 	SerdNode   suri  = serd_node_new_file_uri((const uint8_t*)path, 0, 0, true);
 	LilvNode*  node  = lilv_new_uri(world, (const char*)suri.buf);
 
-	lilv_world_load_bundle(world, node);
+	if (!world->cache ||
+	    !lilv_cache_check_bundle(world->cache, path, node->node) ||
+	    !lilv_world_restore_bundle(world, node)) {
+		lilv_world_load_bundle(world, node);
+	}
+
 	lilv_node_free(node);
 	serd_node_free(&suri);
 	free(path);
 }
 
-/** Load all bundles in the directory at `dir_path`. */
-static void
-lilv_world_load_directory(LilvWorld* world, const char* dir_path)
-{
-	char* path = lilv_expand(dir_path);
-	if (path) {
-		lilv_dir_for_each(path, world, load_dir_entry);
-		free(path);
-	}
-}
-
 static const char*
 first_path_sep(const char* path)
 {
@@ -988,6 +1583,297 @@ first_path_sep(const char* path)
 	return NULL;
 }
 
+/** Call `f` for every expanded directory path in `lv2_path`. */
+void
+lilv_world_for_each_path_dir(const char* lv2_path,
+                             void*       data,
+                             void (*f)(const char*, void*))
+{
+	while (lv2_path[0] != '\0') {
+		const char* const sep     = first_path_sep(lv2_path);
+		const size_t      dir_len = sep ? (size_t)(sep - lv2_path)
+		                                : strlen(lv2_path);
+
+		char* const dir = (char*)malloc(dir_len + 1);
+		memcpy(dir, lv2_path, dir_len);
+		dir[dir_len] = '\0';
+
+		char* const path = lilv_expand(dir);
+		if (path) {
+			f(path, data);
+			free(path);
+		}
+
+		free(dir);
+		lv2_path += sep ? dir_len + 1 : dir_len;
+	}
+}
+
+typedef struct {
+	void* data;
+	void (*f)(const char*, const char*, void*);
+} LilvScanClosure;
+
+static void
+scan_path_dir(const char* dir_path, void* data)
+{
+	const LilvScanClosure* const closure = (const LilvScanClosure*)data;
+
+	lilv_dir_for_each(dir_path, closure->data, closure->f);
+}
+
+/** Call `f` for every entry in every directory in `lv2_path`. */
+static void
+lilv_world_scan_path(const char* lv2_path,
+                     void*       data,
+                     void (*f)(const char*, const char*, void*))
+{
+	LilvScanClosure closure = {data, f};
+
+	lilv_world_for_each_path_dir(lv2_path, &closure, scan_path_dir);
+}
+
+#ifdef HAVE_PTHREAD
+
+/** A bundle found in LV2_PATH, to be loaded along with many others. */
+typedef struct {
+	char*      path;      ///< Bundle directory path
+	LilvNode*  uri;       ///< Bundle URI
+	LilvNode*  manifest;  ///< Manifest URI
+	char*      prefix;    ///< Blank node prefix, if manifest is read by a thread
+	SordModel* model;     ///< Manifest statements read by a thread
+	SerdStatus st;        ///< Status of reading manifest into model
+	double     time;      ///< Time spent reading manifest into model
+	bool       cached;    ///< True if bundle is unchanged in discovery cache
+} LilvBundleEntry;
+
+typedef struct {
+	LilvWorld*       world;
+	LilvBundleEntry* entries;
+	size_t           n_entries;
+} LilvBundleList;
+
+/** A thread that reads manifests into its own world, for thread safety. */
+typedef struct {
+	LilvBundleEntry** jobs;
+	size_t            n_jobs;
+	unsigned          index;
+	unsigned          n_threads;
+	SordWorld*        world;
+	pthread_t         thread;
+	bool              started;
+} LilvLoadThread;
+
+static void
+collect_dir_entry(const char* dir, const char* name, void* data)
+{
+	LilvBundleList* const list  = (LilvBundleList*)data;
+	LilvWorld* const      world = list->world;
+	char* const           path  = lilv_strjoin(dir, "/", name, "/", NULL);
+	SerdNode suri = serd_node_new_file_uri((const uint8_t*)path, 0, 0, true);
+
+	list->entries = (LilvBundleEntry*)realloc(
+		list->entries, (list->n_entries + 1) * sizeof(LilvBundleEntry));
+
+	LilvBundleEntry* const entry = &list->entries[list->n_entries++];
+	memset(entry, 0, sizeof(LilvBundleEntry));
+	entry->path     = path;
+	entry->uri      = lilv_new_uri(world, (const char*)suri.buf);
+	entry->manifest = lilv_world_get_manifest_uri(world, entry->uri);
+
+	serd_node_free(&suri);
+}
+
+static void*
+load_thread_run(void* data)
+{
+	LilvLoadThread* const thread = (LilvLoadThread*)data;
+
+	for (size_t i = thread->index; i < thread->n_jobs; i += thread->n_threads) {
+		LilvBundleEntry* const entry  = thread->jobs[i];
+		const SordNode* const  uri    = entry->manifest->node;
+		SerdEnv* const         env    = serd_env_new(sord_node_to_serd_node(uri));
+		SordModel* const       model  = sord_new(thread->world, SORD_SPO, false);
+		SerdReader* const      reader = sord_new_reader(
+			model, env, SERD_TURTLE, NULL);
+
+		const double start = lilv_time_now();
+
+		serd_reader_add_blank_prefix(reader, (const uint8_t*)entry->prefix);
+		entry->st    = serd_reader_read_file(reader, sord_node_get_string(uri));
+		entry->model = model;
+		entry->time  = lilv_time_now() - start;
+
+		serd_reader_free(reader);
+		serd_env_free(env);
+	}
+
+	return NULL;
+}
+
+/** Return a copy of a node from a thread's world in the main world. */
+static SordNode*
+lilv_world_import_node(LilvWorld* world, const SordNode* node)
+{
+	const uint8_t* const str = sord_node_get_string(node);
+	switch (sord_node_get_type(node)) {
+	case SORD_URI:
+		return sord_new_uri(world->world, str);
+	case SORD_BLANK:
+		return sord_new_blank(world->world, str);
+	case SORD_LITERAL:
+		break;
+	}
+
+	const SordNode* const datatype = sord_node_get_datatype(node);
+	SordNode* const       dt_node  = datatype ? lilv_world_import_node(
+		world, datatype) : NULL;
+
+	SordNode* const literal = sord_new_literal(
+		world->world, dt_node, str, sord_node_get_language(node));
+
+	sord_node_free(world->world, dt_node);
+	return literal;
+}
+
+/** Add all statements in a thread's model to the world with `graph`. */
+static void
+lilv_world_import_model(LilvWorld* world, SordModel* model, SordNode* graph)
+{
+	SordIter* i = sord_begin(model);
+	FOREACH_MATCH(i) {
+		SordQuad quad = { NULL, NULL, NULL, graph };
+		for (unsigned f = 0; f < 3; ++f) {
+			quad[f] = lilv_world_import_node(
+				world, sord_iter_get_node(i, (SordQuadIndex)f));
+		}
+
+		sord_add(world->model, quad);
+
+		for (unsigned f = 0; f < 3; ++f) {
+			sord_node_free(world->world, (SordNode*)quad[f]);
+		}
+	}
+	sord_iter_free(i);
+}
+
+/** Load a bundle which has been read by a thread, or otherwise as usual. */
+static void
+lilv_world_load_entry(LilvWorld* world, LilvBundleEntry* entry)
+{
+	if (entry->cached && lilv_world_restore_bundle(world, entry->uri)) {
+		return;
+	} else if (!entry->model ||
+	           lilv_collection_find(world->loaded_files, entry->manifest)) {
+		// Not read by a thread, or since loaded by an earlier duplicate entry
+		lilv_world_load_bundle(world, entry->uri);
+		return;
+	}
+
+	lilv_world_add_bundle_stats(world, entry->uri);
+	lilv_world_add_parse_time(
+		world, lilv_node_as_string(entry->manifest), entry->time);
+	++world->stats.n_files;
+
+	// Keep anything read before an error, like lilv_world_load_file() does
+	world->stats.n_statements += sord_num_quads(entry->model);
+	lilv_world_import_model(world, entry->model, entry->uri->node);
+
+	if (entry->st) {
+		LILV_ERRORF("Error loading file `%s'\n",
+		            lilv_node_as_string(entry->manifest));
+		if (entry->st > SERD_FAILURE) {
+			LILV_ERRORF("Error reading %s\n",
+			            lilv_node_as_string(entry->manifest));
+			return;
+		}
+	} else {
+		lilv_collection_insert(world->loaded_files,
+		                       lilv_node_duplicate(entry->manifest));
+
+		if (world->cache) {
+			lilv_cache_capture_bundle(world->cache, entry->uri->node);
+		}
+	}
+
+	lilv_world_add_bundle(world, entry->uri, entry->manifest);
+}
+
+/**
+   Load many bundles, reading manifests in several threads.
+
+   Manifests are read by threads into models in their own worlds, since
+   nodes may not be created concurrently in one world.  The results are then
+   added to the world, in order, exactly as if each bundle was loaded in turn.
+*/
+static void
+lilv_world_load_bundle_list(LilvWorld* world, LilvBundleList* list)
+{
+	LilvBundleEntry** jobs = (LilvBundleEntry**)calloc(
+		list->n_entries ? list->n_entries : 1, sizeof(LilvBundleEntry*));
+
+	// Decide which manifests need to be read before starting any threads
+	size_t n_jobs = 0;
+	for (size_t i = 0; i < list->n_entries; ++i) {
+		LilvBundleEntry* const entry = &list->entries[i];
+		if (world->cache && lilv_cache_check_bundle(
+			    world->cache, entry->path, entry->uri->node)) {
+			entry->cached = true;
+		} else if (!lilv_collection_find(world->loaded_files,
+		                                 entry->manifest)) {
+			entry->prefix = lilv_strdup(
+				(const char*)lilv_world_blank_node_prefix(world));
+			jobs[n_jobs++] = entry;
+		}
+	}
+
+	// Read manifests in threads
+	const unsigned n_threads =
+		(world->opt.load_threads < n_jobs) ? world->opt.load_threads
+		                                   : (unsigned)n_jobs;
+
+	LilvLoadThread* const threads = (LilvLoadThread*)calloc(
+		n_threads ? n_threads : 1, sizeof(LilvLoadThread));
+	for (unsigned t = 0; t < n_threads; ++t) {
+		threads[t].jobs      = jobs;
+		threads[t].n_jobs    = n_jobs;
+		threads[t].index     = t;
+		threads[t].n_threads = n_threads;
+		threads[t].world     = sord_world_new();
+		threads[t].started   = !pthread_create(
+			&threads[t].thread, NULL, load_thread_run, &threads[t]);
+	}
+
+	for (unsigned t = 0; t < n_threads; ++t) {
+		if (threads[t].started) {
+			pthread_join(threads[t].thread, NULL);
+		} else {
+			load_thread_run(&threads[t]);
+		}
+	}
+
+	// Load everything in the same order as a sequential scan would
+	for (size_t i = 0; i < list->n_entries; ++i) {
+		LilvBundleEntry* const entry = &list->entries[i];
+		lilv_world_load_entry(world, entry);
+
+		sord_free(entry->model);
+		lilv_node_free(entry->manifest);
+		lilv_node_free(entry->uri);
+		free(entry->prefix);
+		free(entry->path);
+	}
+
+	for (unsigned t = 0; t < n_threads; ++t) {
+		sord_world_free(threads[t].world);
+	}
+
+	free(threads);
+	free(jobs);
+}
+
+#endif  // HAVE_PTHREAD
+
 /** Load all bundles found in `lv2_path`.
  * @param lv2_path A colon-delimited list of directories.  These directories
  * should contain LV2 bundle directories (ie the search path is a list of
@@ -997,32 +1883,97 @@ static void
 lilv_world_load_path(LilvWorld*  world,
                      const char* lv2_path)
 {
-	while (lv2_path[0] != '\0') {
-		const char* const sep = first_path_sep(lv2_path);
-		if (sep) {
-			const size_t dir_len = sep - lv2_path;
-			char* const  dir     = (char*)malloc(dir_len + 1);
-			memcpy(dir, lv2_path, dir_len);
-			dir[dir_len] = '\0';
-			lilv_world_load_directory(world, dir);
-			free(dir);
-			lv2_path += dir_len + 1;
-		} else {
-			lilv_world_load_directory(world, lv2_path);
-			lv2_path = "\0";
+#ifdef HAVE_PTHREAD
+	if (world->opt.load_threads > 1) {
+		LilvBundleList list = { world, NULL, 0 };
+		lilv_world_scan_path(lv2_path, &list, collect_dir_entry);
+		lilv_world_load_bundle_list(world, &list);
+		free(list.entries);
+		return;
+	}
+#endif
+
+	lilv_world_scan_path(lv2_path, world, load_dir_entry);
+}
+
+/** Load the data files of a specification if they have not been loaded. */
+static void
+lilv_world_load_spec(LilvWorld* world, LilvSpec* spec)
+{
+	if (spec->loaded) {
+		return;
+	}
+
+	spec->loaded = true;
+	LILV_FOREACH(nodes, f, spec->data_uris) {
+		LilvNode* file = (LilvNode*)lilv_collection_get(spec->data_uris, f);
+		lilv_world_load_graph(world, NULL, file);
+	}
+
+	if (world->plugin_classes_loaded) {
+		// Add any classes defined by this specification
+		lilv_world_load_plugin_classes(world);
+	}
+}
+
+/** Return true if `uri` is `ns` itself or a term in that namespace. */
+static bool
+lilv_uri_in_namespace(const char* uri, const char* ns)
+{
+	const size_t ns_len = strlen(ns);
+	if (ns_len == 0 || strncmp(uri, ns, ns_len)) {
+		return false;
+	}
+
+	const char last = ns[ns_len - 1];
+	const char next = uri[ns_len];
+	return (last == '#' || last == '/' ||
+	        next == '\0' || next == '#' || next == '/');
+}
+
+void
+lilv_world_load_namespace(LilvWorld* world, const SordNode* node)
+{
+	if (!world->opt.lazy_specifications || world->frozen || !node ||
+	    sord_node_get_type(node) != SORD_URI) {
+		return;  // Specifications are only loaded by lilv_world_load_all()
+	}
+
+	// Check for unloaded specifications while other threads may be reading
+	const char* const uri    = (const char*)sord_node_get_string(node);
+	bool              needed = false;
+	lilv_world_read_lock(world);
+	for (LilvSpec* spec = world->specs; spec && !needed; spec = spec->next) {
+		needed = !spec->loaded && lilv_uri_in_namespace(
+			uri, (const char*)sord_node_get_string(spec->spec));
+	}
+	lilv_world_read_unlock(world);
+
+	if (needed) {
+		lilv_world_write_lock(world);
+		for (LilvSpec* spec = world->specs; spec; spec = spec->next) {
+			if (!spec->loaded &&
+			    lilv_uri_in_namespace(
+				    uri, (const char*)sord_node_get_string(spec->spec))) {
+				lilv_world_load_spec(world, spec);
+			}
 		}
+		lilv_world_write_unlock(world);
 	}
 }
 
 void
 lilv_world_load_specifications(LilvWorld* world)
 {
+	if (world->frozen) {
+		return;  // Everything was loaded by lilv_world_freeze()
+	}
+
+	lilv_world_write_lock(world);
 	for (LilvSpec* spec = world->specs; spec; spec = spec->next) {
-		LILV_FOREACH(nodes, f, spec->data_uris) {
-			LilvNode* file = (LilvNode*)lilv_collection_get(spec->data_uris, f);
-			lilv_world_load_graph(world, NULL, file);
-		}
+		lilv_world_load_spec(world, spec);
 	}
+	lilv_world_write_unlock(world);
 }
 
 void
@@ -1033,7 +1984,13 @@ lilv_world_load_plugin_classes(LilvWorld* world)
 	   starting with lv2:Plugin as the root (which is e.g. how a host would build
 	   a menu), they won't be seen anyway...
 	*/
+	if (world->frozen) {
+		return;  // Everything was loaded by lilv_world_freeze()
+	}
 
+	lilv_world_write_lock(world);
+
+	unsigned  n_added = 0;
 	SordIter* classes = sord_search(world->model,
 	                                NULL,
 	                                world->uris.rdf_a,
@@ -1058,18 +2015,49 @@ lilv_world_load_plugin_classes(LilvWorld* world)
 		LilvPluginClass* pclass = lilv_plugin_class_new(
 			world, parent, class_node,
 			(const char*)sord_node_get_string(label));
-		if (pclass) {
-			zix_tree_insert((ZixTree*)world->plugin_classes, pclass, NULL);
+		if (pclass &&
+		    lilv_collection_insert(world->plugin_classes, pclass)) {
+			// Class was already loaded
+			lilv_plugin_class_free(pclass);
+		} else if (pclass) {
+			lilv_uri_index_insert(&world->class_uris,
+			                      (struct LilvHeader*)pclass);
+			++n_added;
 		}
 
 		sord_node_free(world->world, label);
 		sord_node_free(world->world, parent);
 	}
 	sord_iter_free(classes);
+
+	if (n_added > 0) {
+		lilv_plugin_classes_link(world);
+	}
+
+	world->plugin_classes_loaded = true;
+	lilv_world_write_unlock(world);
 }
 
 void
-lilv_world_load_all(LilvWorld* world)
+lilv_world_load_plugin_classes_if_necessary(LilvWorld* world)
+{
+	lilv_world_read_lock(world);
+	const bool loaded = world->plugin_classes_loaded;
+	lilv_world_read_unlock(world);
+
+	if (!loaded) {
+		lilv_world_write_lock(world);
+		if (!world->plugin_classes_loaded) {
+			// Plugin classes are defined in the LV2 core specification
+			lilv_world_load_namespace(world, world->uris.lv2_Plugin);
+			lilv_world_load_plugin_classes(world);
+		}
+		lilv_world_write_unlock(world);
+	}
+}
+
+const char*
+lilv_world_get_lv2_path(const LilvWorld* world)
 {
 	const char* lv2_path = world->opt.lv2_path;
 	if (!lv2_path) {
@@ -1079,12 +2067,37 @@ lilv_world_load_all(LilvWorld* world)
 		lv2_path = LILV_DEFAULT_LV2_PATH;
 	}
 
+	return lv2_path;
+}
+
+void
+lilv_world_load_all(LilvWorld* world)
+{
+	if (world->frozen) {
+		LILV_ERROR("World is frozen\n");
+		return;
+	}
+
+	const char* const lv2_path = lilv_world_get_lv2_path(world);
+
+	lilv_world_write_lock(world);
+
+	if (world->opt.discovery_cache) {
+		world->cache = lilv_cache_new(world, world->opt.discovery_cache);
+	}
+
 	// Discover bundles and read all manifest files into model
 	lilv_world_load_path(world, lv2_path);
 
+	if (world->cache) {
+		lilv_cache_write(world->cache);
+		lilv_cache_free(world->cache);
+		world->cache = NULL;
+	}
+
 	LILV_FOREACH(plugins, p, world->plugins) {
-		const LilvPlugin* plugin = (const LilvPlugin*)lilv_collection_get(
-			(ZixTree*)world->plugins, p);
+		const LilvPlugin* plugin =
+			(const LilvPlugin*)lilv_collection_get(world->plugins, p);
 
 		// ?new dc:replaces plugin
 		if (sord_ask(world->model,
@@ -1097,16 +2110,43 @@ lilv_world_load_all(LilvWorld* world)
 		}
 	}
 
-	// Query out things to cache
+	if (world->opt.lazy_specifications) {
+		// Load specifications and plugin classes when they are first needed
+		world->plugin_classes_loaded = false;
+	} else {
+		// Query out things to cache
+		lilv_world_load_specifications(world);
+		lilv_world_load_plugin_classes(world);
+	}
+
+	lilv_world_write_unlock(world);
+}
+
+void
+lilv_world_freeze(LilvWorld* world)
+{
+	if (world->frozen) {
+		return;
+	}
+
+	// Load everything that would otherwise be loaded when first queried
 	lilv_world_load_specifications(world);
-	lilv_world_load_plugin_classes(world);
+	lilv_world_load_plugin_classes_if_necessary(world);
+	LILV_FOREACH(plugins, i, world->plugins) {
+		lilv_plugin_load_all((LilvPlugin*)lilv_plugins_get(world->plugins, i));
+	}
+	lilv_world_load_plugin_index_if_necessary(world);
+	lilv_world_load_text_index_if_necessary(world);
+
+	lilv_world_decode_literals(world);
+
+	world->frozen = true;
 }
 
 SerdStatus
 lilv_world_load_file(LilvWorld* world, SerdReader* reader, const LilvNode* uri)
 {
-	ZixTreeIter* iter = NULL;
-	if (!zix_tree_find((ZixTree*)world->loaded_files, uri, &iter)) {
+	if (lilv_collection_find(world->loaded_files, uri)) {
 		return SERD_FAILURE;  // File has already been loaded
 	}
 
@@ -1119,16 +2159,23 @@ lilv_world_load_file(LilvWorld* world, SerdReader* reader, const LilvNode* uri)
 		return SERD_FAILURE;  // Not a Turtle file
 	}
 
+	const size_t n_quads = sord_num_quads(world->model);
+	const double start   = lilv_time_now();
+
 	serd_reader_add_blank_prefix(reader, lilv_world_blank_node_prefix(world));
 	const SerdStatus st = serd_reader_read_file(reader, uri_str);
+
+	lilv_world_add_parse_time(
+		world, (const char*)uri_str, lilv_time_now() - start);
+	world->stats.n_statements += sord_num_quads(world->model) - n_quads;
+	++world->stats.n_files;
+
 	if (st) {
 		LILV_ERRORF("Error loading file `%s'\n", lilv_node_as_string(uri));
 		return st;
 	}
 
-	zix_tree_insert((ZixTree*)world->loaded_files,
-	                lilv_node_duplicate(uri),
-	                NULL);
+	lilv_collection_insert(world->loaded_files, lilv_node_duplicate(uri));
 	return SERD_SUCCESS;
 }
 
@@ -1136,12 +2183,19 @@ int
 lilv_world_load_resource(LilvWorld*      world,
                          const LilvNode* resource)
 {
+	if (world->frozen) {
+		LILV_ERROR("World is frozen\n");
+		return -1;
+	}
+
 	if (!lilv_node_is_uri(resource) && !lilv_node_is_blank(resource)) {
 		LILV_ERRORF("Node `%s' is not a resource\n",
 		            sord_node_get_string(resource->node));
 		return -1;
 	}
 
+	lilv_world_write_lock(world);
+
 	SordModel* files = lilv_world_filter_model(world,
 	                                           world->model,
 	                                           resource->node,
@@ -1164,6 +2218,7 @@ lilv_world_load_resource(LilvWorld*      world,
 	sord_iter_free(f);
 
 	sord_free(files);
+	lilv_world_write_unlock(world);
 	return n_read;
 }
 
@@ -1171,12 +2226,19 @@ int
 lilv_world_unload_resource(LilvWorld*      world,
                            const LilvNode* resource)
 {
+	if (world->frozen) {
+		LILV_ERROR("World is frozen\n");
+		return -1;
+	}
+
 	if (!lilv_node_is_uri(resource) && !lilv_node_is_blank(resource)) {
 		LILV_ERRORF("Node `%s' is not a resource\n",
 		            sord_node_get_string(resource->node));
 		return -1;
 	}
 
+	lilv_world_write_lock(world);
+
 	SordModel* files = lilv_world_filter_model(world,
 	                                           world->model,
 	                                           resource->node,
@@ -1200,6 +2262,8 @@ lilv_world_unload_resource(LilvWorld*      world,
 	sord_iter_free(f);
 
 	sord_free(files);
+	lilv_world_clear_literals(world);
+	lilv_world_write_unlock(world);
 	return n_dropped;
 }
 
@@ -1212,6 +2276,7 @@ lilv_world_get_plugin_class(const LilvWorld* world)
 const LilvPluginClasses*
 lilv_world_get_plugin_classes(const LilvWorld* world)
 {
+	lilv_world_load_plugin_classes_if_necessary((LilvWorld*)world);
 	return world->plugin_classes;
 }
 
@@ -1225,13 +2290,17 @@ LilvNode*
 lilv_world_get_symbol(LilvWorld* world, const LilvNode* subject)
 {
 	// Check for explicitly given symbol
+	lilv_world_read_lock(world);
+	lilv_world_lock(world);
 	SordNode* snode = sord_get(
 		world->model, subject->node, world->uris.lv2_symbol, NULL, NULL);
 
-	if (snode) {
-		LilvNode* ret = lilv_node_new_from_node(world, snode);
-		sord_node_free(world->world, snode);
-		return ret;
+	LilvNode* given = lilv_node_new_from_node(world, snode);
+	sord_node_free(world->world, snode);
+	lilv_world_unlock(world);
+	lilv_world_read_unlock(world);
+	if (given) {
+		return given;
 	}
 
 	if (!lilv_node_is_uri(subject)) {
@@ -1268,3 +2337,60 @@ lilv_world_get_symbol(LilvWorld* world, const LilvNode* subject)
 	free(sym);
 	return ret;
 }
+
+void
+lilv_world_get_stats(const LilvWorld* world, LilvWorldStats* stats)
+{
+	LilvWorld* const w = (LilvWorld*)world;
+
+	lilv_world_read_lock(w);
+	lilv_world_lock(w);
+
+	*stats                  = world->stats;
+	stats->model_statements = sord_num_quads(world->model);
+	stats->model_nodes      = sord_num_nodes(world->world);
+	stats->model_size =
+		stats->model_statements *
+			(sizeof(SordQuad) + LILV_N_MODEL_INDICES * sizeof(void*)) +
+		stats->model_nodes * LILV_NODE_SIZE_ESTIMATE;
+
+	lilv_world_unlock(w);
+	lilv_world_read_unlock(w);
+}
+
+void
+lilv_world_reset_stats(LilvWorld* world)
+{
+	lilv_world_read_lock(world);
+	lilv_world_lock(world);
+
+	memset(&world->stats, 0, sizeof(world->stats));
+	for (ZixTreeIter* i = zix_tree_begin(world->bundle_stats);
+	     !zix_tree_iter_is_end(i);
+	     i = zix_tree_iter_next(i)) {
+		((LilvBundleStats*)zix_tree_get(i))->parse_time = 0.0;
+	}
+
+	lilv_world_unlock(world);
+	lilv_world_read_unlock(world);
+}
+
+double
+lilv_world_get_bundle_parse_time(const LilvWorld* world,
+                                 const LilvNode*  bundle_uri)
+{
+	LilvWorld* const w    = (LilvWorld*)world;
+	LilvBundleStats  key  = { (char*)lilv_node_as_string(bundle_uri), 0.0 };
+	ZixTreeIter*     iter = NULL;
+	double           time = 0.0;
+
+	lilv_world_read_lock(w);
+	lilv_world_lock(w);
+	if (!zix_tree_find(world->bundle_stats, &key, &iter)) {
+		time = ((const LilvBundleStats*)zix_tree_get(iter))->parse_time;
+	}
+	lilv_world_unlock(w);
+	lilv_world_read_unlock(w);
+
+	return time;
+}
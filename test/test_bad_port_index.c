@@ -51,6 +51,11 @@ main(void)
 	uint32_t n_ports = lilv_plugin_get_num_ports(plug);
 	assert(n_ports == 0);
 
+	// Invalid ports are not loaded again, so a frozen world never changes them
+	lilv_world_freeze(world);
+	assert(lilv_plugin_get_num_ports(plug) == 0);
+	assert(!lilv_plugin_get_port_by_index(plug, 0));
+
 	delete_bundle(env);
 	lilv_test_env_free(env);
 
@@ -0,0 +1,69 @@
+/*
+  Copyright 2007-2020 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <string.h>
+
+static const char* const manifest_ttl = "\
+:plug a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n\
+:foobar a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n";
+
+static const char* const plugin_ttl = "\
+:plug doap:name \"First plugin\" .\n\
+:foobar doap:name \"Second plugin\" .\n";
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	if (start_bundle(env, manifest_ttl, plugin_ttl)) {
+		return 1;
+	}
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug1 =
+	    lilv_plugins_get_by_uri(plugins, env->plugin1_uri);
+	const LilvPlugin* plug2 =
+	    lilv_plugins_get_by_uri(plugins, env->plugin2_uri);
+	assert(plug1);
+	assert(plug2);
+
+	const LilvNode* const name1 = lilv_plugin_borrow_name(plug1);
+	assert(!strcmp(lilv_node_as_string(name1), "First plugin"));
+
+	// Loading another plugin's data does not forget borrowed names
+	const LilvNode* const name2 = lilv_plugin_borrow_name(plug2);
+	assert(!strcmp(lilv_node_as_string(name2), "Second plugin"));
+	assert(lilv_plugin_borrow_name(plug1) == name1);
+	assert(!strcmp(lilv_node_as_string(name1), "First plugin"));
+
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
@@ -35,6 +35,21 @@ static const char* const plugin_ttl = "\
 		lv2:name \"Foo\" ;\n\
 ] .";
 
+static const char* const spec_manifest_ttl = "\
+<http://example.org/ns>\n\
+	a lv2:Specification ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n\
+<http://example.org/other#BarPlugin>\n\
+	a rdfs:Class ;\n\
+	rdfs:subClassOf lv2:Plugin ;\n\
+	rdfs:label \"Bar\" .\n";
+
+static const char* const spec_ttl = "\
+<http://example.org/ns#FooPlugin>\n\
+	a rdfs:Class ;\n\
+	rdfs:subClassOf lv2:Plugin ;\n\
+	rdfs:label \"Foo\" .\n";
+
 int
 main(void)
 {
@@ -63,6 +78,40 @@ main(void)
 		                        lilv_plugin_class_get_uri(plugin)));
 	}
 
+	const LilvPluginClasses* subclasses =
+	    lilv_plugin_class_get_subclasses(plugin);
+
+	assert(lilv_plugin_classes_size(subclasses) ==
+	       lilv_plugin_classes_size(children));
+
+	LILV_FOREACH (plugin_classes, i, subclasses) {
+		const LilvPluginClass* c = lilv_plugin_classes_get(subclasses, i);
+		assert(lilv_plugin_class_get_parent(c) == plugin);
+		assert(lilv_plugin_class_is_a(c, plugin));
+		assert(!lilv_plugin_class_is_a(plugin, c));
+	}
+
+	const LilvPlugin* plug =
+	    lilv_plugins_get_by_uri(lilv_world_get_all_plugins(world),
+	                            env->plugin1_uri);
+	const LilvPluginClass* klass = lilv_plugin_get_class(plug);
+
+	LilvNode* dynamics_uri =
+	    lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#DynamicsPlugin");
+	const LilvPluginClass* dynamics =
+	    lilv_plugin_classes_get_by_uri(classes, dynamics_uri);
+
+	assert(dynamics);
+	assert(lilv_plugin_class_get_parent(klass) == dynamics);
+	assert(lilv_plugin_classes_get_by_uri(
+	           lilv_plugin_class_get_subclasses(dynamics),
+	           lilv_plugin_class_get_uri(klass)) == klass);
+	assert(lilv_plugin_class_is_a(klass, klass));
+	assert(lilv_plugin_class_is_a(klass, dynamics));
+	assert(lilv_plugin_class_is_a(klass, plugin));
+	assert(!lilv_plugin_class_is_a(dynamics, klass));
+	lilv_node_free(dynamics_uri);
+
 	LilvNode* some_uri = lilv_new_uri(world, "http://example.org/whatever");
 	assert(lilv_plugin_classes_get_by_uri(classes, some_uri) == NULL);
 	lilv_node_free(some_uri);
@@ -71,5 +120,52 @@ main(void)
 	delete_bundle(env);
 	lilv_test_env_free(env);
 
+	// Subclasses stay valid when a lazily loaded specification adds classes
+	LilvTestEnv* const lazy_env = lilv_test_env_new();
+	LilvWorld* const   lazy     = lazy_env->world;
+	LilvNode* const    lazy_opt = lilv_new_bool(lazy, true);
+	lilv_world_set_option(lazy, LILV_OPTION_LAZY_SPECIFICATIONS, lazy_opt);
+	lilv_node_free(lazy_opt);
+	if (start_bundle(lazy_env, spec_manifest_ttl, spec_ttl)) {
+		return 1;
+	}
+
+	const LilvPluginClass*   root = lilv_world_get_plugin_class(lazy);
+	const LilvPluginClasses* root_subclasses =
+	    lilv_plugin_class_get_subclasses(root);
+	const unsigned n_subclasses = lilv_plugin_classes_size(root_subclasses);
+
+	LilvNode* foo_uri = lilv_new_uri(lazy, "http://example.org/ns#FooPlugin");
+	assert(!lilv_plugin_classes_get_by_uri(root_subclasses, foo_uri));
+
+	// Iterators remain valid while the collection grows
+	LilvIter* const first = lilv_plugin_classes_begin(root_subclasses);
+	assert(first);
+
+	// Querying a subject in the specification namespace loads it
+	LilvNode* rdfs_label =
+	    lilv_new_uri(lazy, "http://www.w3.org/2000/01/rdf-schema#label");
+	assert(lilv_world_ask(lazy, foo_uri, rdfs_label, NULL));
+
+	assert(lilv_plugin_class_get_subclasses(root) == root_subclasses);
+	assert(lilv_plugin_classes_size(root_subclasses) == n_subclasses + 1);
+	const LilvPluginClass* foo =
+	    lilv_plugin_classes_get_by_uri(root_subclasses, foo_uri);
+	assert(foo);
+	assert(lilv_plugin_class_get_parent(foo) == root);
+
+	unsigned n_iterated = 0;
+	for (LilvIter* i = first; !lilv_plugin_classes_is_end(root_subclasses, i);
+	     i = lilv_plugin_classes_next(root_subclasses, i)) {
+		assert(lilv_plugin_classes_get(root_subclasses, i));
+		++n_iterated;
+	}
+	assert(n_iterated == n_subclasses + 1);
+
+	lilv_node_free(rdfs_label);
+	lilv_node_free(foo_uri);
+	delete_bundle(lazy_env);
+	lilv_test_env_free(lazy_env);
+
 	return 0;
 }
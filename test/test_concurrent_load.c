@@ -0,0 +1,159 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_config.h"
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#ifdef HAVE_PTHREAD
+#    include <pthread.h>
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define N_THREADS 4
+#define N_ROUNDS  32
+
+static const char* const manifest_ttl = "\
+:plug a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n\
+:foobar a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n";
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	a lv2:CompressorPlugin ;\n\
+	doap:name \"First plugin\" ;\n\
+	lv2:port [\n\
+		a lv2:ControlPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"foo\" ;\n\
+		lv2:name \"bar\" ;\n\
+	] .\n\
+:foobar a lv2:Plugin ;\n\
+	a lv2:DynamicsPlugin ;\n\
+	doap:name \"Second plugin\" ;\n\
+	lv2:port [\n\
+		a lv2:AudioPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"in\" ;\n\
+		lv2:name \"In\" ;\n\
+	] , [\n\
+		a lv2:AudioPort ;\n\
+		a lv2:OutputPort ;\n\
+		lv2:index 1 ;\n\
+		lv2:symbol \"out\" ;\n\
+		lv2:name \"Out\" ;\n\
+	] .\n";
+
+typedef struct {
+	LilvTestEnv* env;
+	unsigned     index;
+	unsigned     n_ok;
+} QueryThread;
+
+static bool
+check_plugin(const LilvPlugin* plug,
+             const char*       name,
+             const char*       class_label,
+             uint32_t          n_ports)
+{
+	LilvNode* const plug_name = lilv_plugin_get_name(plug);
+	const bool      ok =
+		plug_name && !strcmp(lilv_node_as_string(plug_name), name) &&
+		lilv_plugin_get_num_ports(plug) == n_ports &&
+		!strcmp(lilv_node_as_string(lilv_plugin_class_get_label(
+			        lilv_plugin_get_class(plug))),
+		        class_label);
+
+	lilv_node_free(plug_name);
+	return ok;
+}
+
+static void*
+query_run(void* data)
+{
+	QueryThread* const thread  = (QueryThread*)data;
+	LilvTestEnv* const env     = thread->env;
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(env->world);
+
+	const LilvPlugin* plug1 = lilv_plugins_get_by_uri(plugins, env->plugin1_uri);
+	const LilvPlugin* plug2 = lilv_plugins_get_by_uri(plugins, env->plugin2_uri);
+
+	for (unsigned i = 0; i < N_ROUNDS; ++i) {
+		// Alternate which plugin is first, so both are loaded concurrently
+		const bool first    = (thread->index + i) % 2;
+		const bool first_ok =
+			first ? check_plugin(plug1, "First plugin", "Compressor", 1)
+			      : check_plugin(plug2, "Second plugin", "Dynamics", 2);
+		const bool second_ok =
+			first ? check_plugin(plug2, "Second plugin", "Dynamics", 2)
+			      : check_plugin(plug1, "First plugin", "Compressor", 1);
+
+		if (first_ok && second_ok) {
+			++thread->n_ok;
+		}
+	}
+
+	return NULL;
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env = lilv_test_env_new();
+
+	if (start_bundle(env, manifest_ttl, plugin_ttl)) {
+		return 1;
+	}
+
+	QueryThread threads[N_THREADS];
+	memset(threads, 0, sizeof(threads));
+
+#ifdef HAVE_PTHREAD
+	// Query plugins that have not been loaded yet from several threads
+	pthread_t handles[N_THREADS];
+	for (unsigned t = 0; t < N_THREADS; ++t) {
+		threads[t].env   = env;
+		threads[t].index = t;
+		assert(!pthread_create(&handles[t], NULL, query_run, &threads[t]));
+	}
+
+	for (unsigned t = 0; t < N_THREADS; ++t) {
+		pthread_join(handles[t], NULL);
+		assert(threads[t].n_ok == N_ROUNDS);
+	}
+#else
+	threads[0].env = env;
+	query_run(&threads[0]);
+	assert(threads[0].n_ok == N_ROUNDS);
+#endif
+
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
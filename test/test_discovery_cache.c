@@ -0,0 +1,136 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "../src/filesystem.h"
+#include "../src/lilv_internal.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	a lv2:CompressorPlugin ;\n\
+	doap:name \"Test plugin\" ;\n\
+	lv2:port [\n\
+		a lv2:ControlPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"foo\" ;\n\
+		lv2:name \"bar\" ;\n\
+	] .\n";
+
+static const char* const changed_manifest_ttl = "\
+:foobar a lv2:Plugin ;\n\
+	lv2:binary <foobar" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n";
+
+static const char* const changed_plugin_ttl = "\
+:foobar a lv2:Plugin ;\n\
+	doap:name \"Changed plugin\" .\n";
+
+static LilvTestEnv*
+load_with_cache(const char* cache_path)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvNode* const    value = lilv_new_string(env->world, cache_path);
+
+	lilv_world_set_option(env->world, LILV_OPTION_DISCOVERY_CACHE, value);
+	lilv_world_load_all(env->world);
+	lilv_node_free(value);
+
+	return env;
+}
+
+int
+main(void)
+{
+	char* const cache_dir  = lilv_path_join(LILV_TEST_DIR, "discovery_cache");
+	char* const cache_path = lilv_path_join(cache_dir, "cache");
+
+	lilv_remove(cache_path);
+
+	LilvTestEnv* const env = lilv_test_env_new();
+	if (create_bundle(env, SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+		return 1;
+	}
+
+	// Load everything from disk, which should write the cache
+	LilvTestEnv* const first = load_with_cache(cache_path);
+	assert(lilv_path_exists(cache_path));
+	assert(lilv_plugins_get_by_uri(lilv_world_get_all_plugins(first->world),
+	                               first->plugin1_uri));
+	lilv_test_env_free(first);
+
+	// Load again, which should take the unchanged manifests from the cache
+	LilvTestEnv* const second  = load_with_cache(cache_path);
+	LilvWorld* const   world   = second->world;
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug =
+	    lilv_plugins_get_by_uri(plugins, second->plugin1_uri);
+
+	assert(plug);
+	assert(lilv_plugin_verify(plug));
+	assert(lilv_plugin_get_num_ports(plug) == 1);
+	assert(!strcmp(lilv_node_as_uri(lilv_plugin_get_bundle_uri(plug)),
+	               env->test_bundle_uri));
+	assert(strstr(lilv_node_as_uri(lilv_plugin_get_library_uri(plug)),
+	              "foo" SHLIB_EXT));
+	assert(lilv_nodes_size(lilv_plugin_get_data_uris(plug)) == 2);
+
+	LilvNode* name = lilv_plugin_get_name(plug);
+	assert(!strcmp(lilv_node_as_string(name), "Test plugin"));
+	lilv_node_free(name);
+
+	// The core specification should be found via its cached manifest
+	const LilvPluginClass* klass = lilv_plugin_get_class(plug);
+	assert(!strcmp(lilv_node_as_uri(lilv_plugin_class_get_uri(klass)),
+	               "http://lv2plug.in/ns/lv2core#CompressorPlugin"));
+	lilv_test_env_free(second);
+
+	// Replace the bundle, which should be noticed and read from disk
+	delete_bundle(env);
+	if (create_bundle(env, changed_manifest_ttl, changed_plugin_ttl)) {
+		return 1;
+	}
+
+	LilvTestEnv* const third = load_with_cache(cache_path);
+	plugins                  = lilv_world_get_all_plugins(third->world);
+	assert(!lilv_plugins_get_by_uri(plugins, third->plugin1_uri));
+	plug = lilv_plugins_get_by_uri(plugins, third->plugin2_uri);
+	assert(plug);
+
+	name = lilv_plugin_get_name(plug);
+	assert(!strcmp(lilv_node_as_string(name), "Changed plugin"));
+	lilv_node_free(name);
+	lilv_test_env_free(third);
+
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	lilv_remove(cache_path);
+	lilv_remove(cache_dir);
+	free(cache_path);
+	free(cache_dir);
+
+	return 0;
+}
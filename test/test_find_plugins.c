@@ -0,0 +1,165 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+static const char* const manifest_ttl = "\
+:plug a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n\
+:foobar a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n";
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	a lv2:CompressorPlugin ;\n\
+	doap:name \"Stereo compressor\" ;\n\
+	lv2:requiredFeature <http://example.org/feature> ;\n\
+	lv2:port [\n\
+		a lv2:AudioPort , lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"in_l\" ;\n\
+		lv2:name \"Left In\" ;\n\
+	] , [\n\
+		a lv2:AudioPort , lv2:InputPort ;\n\
+		lv2:index 1 ;\n\
+		lv2:symbol \"in_r\" ;\n\
+		lv2:name \"Right In\" ;\n\
+	] , [\n\
+		a lv2:AudioPort , lv2:OutputPort ;\n\
+		lv2:index 2 ;\n\
+		lv2:symbol \"out_l\" ;\n\
+		lv2:name \"Left Out\" ;\n\
+	] , [\n\
+		a lv2:AudioPort , lv2:OutputPort ;\n\
+		lv2:index 3 ;\n\
+		lv2:symbol \"out_r\" ;\n\
+		lv2:name \"Right Out\" ;\n\
+	] .\n\
+:foobar a lv2:Plugin ;\n\
+	a lv2:DynamicsPlugin ;\n\
+	doap:name \"Mono dynamics\" ;\n\
+	lv2:port [\n\
+		a lv2:AudioPort , lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"in\" ;\n\
+		lv2:name \"In\" ;\n\
+	] , [\n\
+		a lv2:AudioPort , lv2:OutputPort ;\n\
+		lv2:index 1 ;\n\
+		lv2:symbol \"out\" ;\n\
+		lv2:name \"Out\" ;\n\
+	] .\n";
+
+static unsigned
+count_plugins(LilvWorld*             world,
+              const LilvPluginClass* plugin_class,
+              const LilvNodes*       features,
+              int32_t                n_inputs,
+              int32_t                n_outputs,
+              const LilvNode*        expected_uri)
+{
+	LilvPlugins* const plugins = lilv_world_find_plugins(
+		world, plugin_class, features, n_inputs, n_outputs);
+
+	const unsigned n_plugins = lilv_plugins_size(plugins);
+	assert(!expected_uri || lilv_plugins_get_by_uri(plugins, expected_uri));
+
+	lilv_plugins_free(plugins);
+	return n_plugins;
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	if (start_bundle(env, manifest_ttl, plugin_ttl)) {
+		return 1;
+	}
+
+	const LilvNode* plug   = env->plugin1_uri;
+	const LilvNode* foobar = env->plugin2_uri;
+
+	LilvNode* dynamics_uri =
+		lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#DynamicsPlugin");
+	LilvNode* compressor_uri =
+		lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#CompressorPlugin");
+
+	const LilvPluginClasses* classes  = lilv_world_get_plugin_classes(world);
+	const LilvPluginClass*   dynamics =
+		lilv_plugin_classes_get_by_uri(classes, dynamics_uri);
+	const LilvPluginClass* compressor =
+		lilv_plugin_classes_get_by_uri(classes, compressor_uri);
+	assert(dynamics);
+	assert(compressor);
+
+	// No criteria
+	assert(count_plugins(world, NULL, NULL, -1, -1, NULL) == 2);
+
+	// By class, including subclasses
+	assert(count_plugins(world, dynamics, NULL, -1, -1, NULL) == 2);
+	assert(count_plugins(world, compressor, NULL, -1, -1, plug) == 1);
+
+	// By audio ports
+	assert(count_plugins(world, NULL, NULL, 2, 2, plug) == 1);
+	assert(count_plugins(world, NULL, NULL, 1, -1, foobar) == 1);
+	assert(count_plugins(world, NULL, NULL, -1, 2, plug) == 1);
+	assert(count_plugins(world, NULL, NULL, 2, 1, NULL) == 0);
+
+	// By supported features
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plugin1 = lilv_plugins_get_by_uri(plugins, plug);
+	const LilvPlugin*  plugin2 = lilv_plugins_get_by_uri(plugins, foobar);
+
+	LilvNodes* features = lilv_plugin_get_required_features(plugin2);
+	assert(lilv_nodes_size(features) == 0);
+	assert(count_plugins(world, NULL, features, -1, -1, foobar) == 1);
+	lilv_nodes_free(features);
+
+	features = lilv_plugin_get_required_features(plugin1);
+	assert(lilv_nodes_size(features) == 1);
+	assert(count_plugins(world, NULL, features, -1, -1, plug) == 2);
+	assert(count_plugins(world, compressor, features, 2, 2, plug) == 1);
+	lilv_nodes_free(features);
+
+	// All criteria combined
+	assert(count_plugins(world, dynamics, NULL, 1, 1, foobar) == 1);
+	assert(count_plugins(world, compressor, NULL, 1, 1, NULL) == 0);
+
+	// Unloading the bundle removes its plugins from the index
+	LilvNode* bundle_uri = lilv_new_uri(world, env->test_bundle_uri);
+	lilv_world_unload_bundle(world, bundle_uri);
+	assert(count_plugins(world, NULL, NULL, -1, -1, NULL) == 0);
+	lilv_node_free(bundle_uri);
+
+	lilv_node_free(compressor_uri);
+	lilv_node_free(dynamics_uri);
+
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
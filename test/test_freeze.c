@@ -0,0 +1,140 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_config.h"
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#ifdef HAVE_PTHREAD
+#    include <pthread.h>
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#define N_THREADS 4
+#define N_ROUNDS  64
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	a lv2:CompressorPlugin ;\n\
+	doap:name \"Test plugin\" ;\n\
+	lv2:port [\n\
+		a lv2:ControlPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"foo\" ;\n\
+		lv2:name \"bar\" ;\n\
+		lv2:minimum -1.0 ;\n\
+		lv2:maximum 1.0 ;\n\
+		lv2:default 0.5\n\
+	] .\n";
+
+typedef struct {
+	LilvTestEnv* env;
+	unsigned     n_ok;
+} QueryThread;
+
+static void*
+query_run(void* data)
+{
+	QueryThread* const thread = (QueryThread*)data;
+	LilvWorld* const   world  = thread->env->world;
+
+	for (unsigned i = 0; i < N_ROUNDS; ++i) {
+		const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+		const LilvPlugin*  plug    =
+			lilv_plugins_get_by_uri(plugins, thread->env->plugin1_uri);
+
+		LilvNode* name = lilv_plugin_get_name(plug);
+		LilvNode* sym  = lilv_new_string(world, "foo");
+
+		const LilvPort*        port  = lilv_plugin_get_port_by_symbol(plug, sym);
+		const LilvPluginClass* klass = lilv_plugin_get_class(plug);
+
+		LilvNode* def = NULL;
+		LilvNode* min = NULL;
+		LilvNode* max = NULL;
+		lilv_port_get_range(plug, port, &def, &min, &max);
+
+		if (!strcmp(lilv_node_as_string(name), "Test plugin") &&
+		    lilv_plugin_get_num_ports(plug) == 1 &&
+		    lilv_port_get_index(plug, port) == 0 &&
+		    !strcmp(lilv_node_as_string(lilv_plugin_class_get_label(klass)),
+		            "Compressor") &&
+		    lilv_node_as_float(def) == 0.5f &&
+		    lilv_node_as_float(min) == -1.0f &&
+		    lilv_node_as_float(max) == 1.0f) {
+			++thread->n_ok;
+		}
+
+		lilv_node_free(max);
+		lilv_node_free(min);
+		lilv_node_free(def);
+		lilv_node_free(sym);
+		lilv_node_free(name);
+	}
+
+	return NULL;
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	if (start_bundle(env, SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+		return 1;
+	}
+
+	lilv_world_freeze(world);
+
+	// Modifying a frozen world fails
+	LilvNode* bundle_uri = lilv_new_uri(world, env->test_bundle_uri);
+	assert(lilv_world_unload_bundle(world, bundle_uri) == -1);
+	assert(lilv_world_load_resource(world, env->plugin1_uri) == -1);
+	lilv_node_free(bundle_uri);
+
+	// Query the plugin from several threads at once
+	QueryThread threads[N_THREADS];
+	memset(threads, 0, sizeof(threads));
+
+#ifdef HAVE_PTHREAD
+	pthread_t handles[N_THREADS];
+	for (unsigned t = 0; t < N_THREADS; ++t) {
+		threads[t].env = env;
+		assert(!pthread_create(&handles[t], NULL, query_run, &threads[t]));
+	}
+
+	for (unsigned t = 0; t < N_THREADS; ++t) {
+		pthread_join(handles[t], NULL);
+		assert(threads[t].n_ok == N_ROUNDS);
+	}
+#else
+	threads[0].env = env;
+	query_run(&threads[0]);
+	assert(threads[0].n_ok == N_ROUNDS);
+#endif
+
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+/*
+  Copyright 2007-2020 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "../src/lilv_internal.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define LV2_CORE_URI "http://lv2plug.in/ns/lv2core"
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	a lv2:CompressorPlugin ;\n\
+	doap:name \"Test plugin\" .\n";
+
+static bool
+core_spec_loaded(const LilvWorld* world)
+{
+	for (const LilvSpec* spec = world->specs; spec; spec = spec->next) {
+		if (!strcmp((const char*)sord_node_get_string(spec->spec),
+		            LV2_CORE_URI)) {
+			return spec->loaded;
+		}
+	}
+
+	assert(false);
+	return false;
+}
+
+static LilvTestEnv*
+load_world(bool lazy)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvNode* const    value = lilv_new_bool(env->world, lazy);
+
+	lilv_world_set_option(env->world, LILV_OPTION_LAZY_SPECIFICATIONS, value);
+	lilv_world_load_all(env->world);
+	lilv_node_free(value);
+
+	return env;
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env = lilv_test_env_new();
+	if (create_bundle(env, SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+		return 1;
+	}
+
+	// Specification data is loaded eagerly by default
+	LilvTestEnv* const plain = lilv_test_env_new();
+	lilv_world_load_all(plain->world);
+	assert(core_spec_loaded(plain->world));
+	lilv_test_env_free(plain);
+
+	// Specification data is loaded eagerly if lazy loading is disabled
+	LilvTestEnv* const eager = load_world(false);
+	assert(core_spec_loaded(eager->world));
+	lilv_test_env_free(eager);
+
+	// Getting the class of a plugin loads the specification that defines it
+	LilvTestEnv* const lazy  = load_world(true);
+	LilvWorld*         world = lazy->world;
+	assert(!core_spec_loaded(world));
+
+	const LilvPlugin* plug = lilv_plugins_get_by_uri(
+		lilv_world_get_all_plugins(world), lazy->plugin1_uri);
+	assert(plug);
+
+	const LilvPluginClass* klass = lilv_plugin_get_class(plug);
+	assert(core_spec_loaded(world));
+	assert(!strcmp(lilv_node_as_uri(lilv_plugin_class_get_uri(klass)),
+	               LV2_CORE_URI "#CompressorPlugin"));
+	lilv_test_env_free(lazy);
+
+	// Querying a subject in the namespace of a specification loads it
+	LilvTestEnv* const query = load_world(true);
+	world                    = query->world;
+	assert(!core_spec_loaded(world));
+
+	LilvNode* compressor =
+		lilv_new_uri(world, LV2_CORE_URI "#CompressorPlugin");
+	LilvNode* rdfs_label =
+		lilv_new_uri(world, "http://www.w3.org/2000/01/rdf-schema#label");
+	LilvNode* label = lilv_world_get(world, compressor, rdfs_label, NULL);
+	assert(core_spec_loaded(world));
+	assert(label);
+	assert(!strcmp(lilv_node_as_string(label), "Compressor"));
+
+	lilv_node_free(label);
+	lilv_node_free(rdfs_label);
+	lilv_node_free(compressor);
+	lilv_test_env_free(query);
+
+	// Queries never load specifications if lazy loading is disabled
+	LilvTestEnv* const manual = lilv_test_env_new();
+	world                     = manual->world;
+
+	LilvNode* core_bundle = lilv_new_file_uri(
+		world, NULL, LILV_TEST_DIR "/test_lv2_path/core.lv2/");
+	lilv_world_load_bundle(world, core_bundle);
+	assert(!core_spec_loaded(world));
+
+	compressor = lilv_new_uri(world, LV2_CORE_URI "#CompressorPlugin");
+	rdfs_label =
+		lilv_new_uri(world, "http://www.w3.org/2000/01/rdf-schema#label");
+	assert(!lilv_world_get(world, compressor, rdfs_label, NULL));
+	assert(!core_spec_loaded(world));
+
+	lilv_node_free(rdfs_label);
+	lilv_node_free(compressor);
+	lilv_node_free(core_bundle);
+	lilv_test_env_free(manual);
+
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
@@ -0,0 +1,135 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <string.h>
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	a lv2:CompressorPlugin ;\n\
+	doap:name \"Test plugin\" ;\n\
+	lv2:port [\n\
+		a lv2:ControlPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"foo\" ;\n\
+		lv2:name \"bar\" ;\n\
+	] .\n";
+
+static const char* const bad_manifest_ttl = "\
+:plug rdfs:label \"Before error\" .\n\
+:plug a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n\
+:plug rdfs:label \"After error\n";
+
+static LilvTestEnv*
+load_world(int n_threads)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvNode* const    value = lilv_new_int(env->world, n_threads);
+
+	lilv_world_set_option(env->world, LILV_OPTION_LOAD_THREADS, value);
+	lilv_world_load_all(env->world);
+	lilv_node_free(value);
+
+	return env;
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	LilvNode* const n_threads = lilv_new_int(world, 4);
+	lilv_world_set_option(world, LILV_OPTION_LOAD_THREADS, n_threads);
+	lilv_node_free(n_threads);
+
+	if (start_bundle(env, SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+		return 1;
+	}
+
+	// Load the same bundles sequentially for comparison
+	LilvTestEnv* const serial_env = lilv_test_env_new();
+	lilv_world_load_all(serial_env->world);
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugins* serial_plugins =
+	    lilv_world_get_all_plugins(serial_env->world);
+
+	assert(lilv_plugins_size(plugins) == lilv_plugins_size(serial_plugins));
+	assert(lilv_plugin_classes_size(lilv_world_get_plugin_classes(world)) ==
+	       lilv_plugin_classes_size(
+	           lilv_world_get_plugin_classes(serial_env->world)));
+
+	const LilvPlugin* plug = lilv_plugins_get_by_uri(plugins, env->plugin1_uri);
+	assert(plug);
+	assert(lilv_plugin_verify(plug));
+	assert(lilv_plugin_get_num_ports(plug) == 1);
+	assert(strstr(lilv_node_as_uri(lilv_plugin_get_library_uri(plug)),
+	              "foo" SHLIB_EXT));
+
+	LilvNode* name = lilv_plugin_get_name(plug);
+	assert(!strcmp(lilv_node_as_string(name), "Test plugin"));
+	lilv_node_free(name);
+
+	const LilvPluginClass* klass = lilv_plugin_get_class(plug);
+	assert(!strcmp(lilv_node_as_uri(lilv_plugin_class_get_uri(klass)),
+	               "http://lv2plug.in/ns/lv2core#CompressorPlugin"));
+
+	lilv_test_env_free(serial_env);
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	// Both modes keep the statements before a syntax error in a manifest
+	LilvTestEnv* const bad_env = lilv_test_env_new();
+	if (create_bundle(bad_env, bad_manifest_ttl, plugin_ttl)) {
+		return 1;
+	}
+
+	LilvTestEnv* const threaded = load_world(4);
+	LilvTestEnv* const serial   = load_world(1);
+
+	LilvWorldStats threaded_stats;
+	LilvWorldStats serial_stats;
+	lilv_world_get_stats(threaded->world, &threaded_stats);
+	lilv_world_get_stats(serial->world, &serial_stats);
+	assert(threaded_stats.model_statements == serial_stats.model_statements);
+
+	LilvWorld* const threaded_world = threaded->world;
+	LilvNode* const  rdfs_label     = lilv_new_uri(
+		threaded_world, "http://www.w3.org/2000/01/rdf-schema#label");
+	LilvNode* const label = lilv_world_get(
+		threaded_world, threaded->plugin1_uri, rdfs_label, NULL);
+	assert(label);
+	assert(!strcmp(lilv_node_as_string(label), "Before error"));
+	lilv_node_free(label);
+	lilv_node_free(rdfs_label);
+
+	lilv_test_env_free(serial);
+	lilv_test_env_free(threaded);
+	delete_bundle(bad_env);
+	lilv_test_env_free(bad_env);
+
+	return 0;
+}
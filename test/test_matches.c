@@ -0,0 +1,80 @@
+/*
+  Copyright 2007-2020 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define RDF_TYPE "http://www.w3.org/1999/02/22-rdf-syntax-ns#type"
+#define LV2_PLUGIN "http://lv2plug.in/ns/lv2core#Plugin"
+
+static const char* const manifest_ttl = "\
+:plug a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n\
+:foobar a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n";
+
+static const char* const plugin_ttl = "\
+:plug doap:name \"First plugin\" .\n\
+:foobar doap:name \"Second plugin\" .\n";
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	if (start_bundle(env, manifest_ttl, plugin_ttl)) {
+		return 1;
+	}
+
+	const LilvPlugins* plugins  = lilv_world_get_all_plugins(world);
+	LilvNode*          rdf_type = lilv_new_uri(world, RDF_TYPE);
+	LilvNode*          plugin_c = lilv_new_uri(world, LV2_PLUGIN);
+
+	// Plugin data may be loaded while stepping through a stream
+	unsigned     n_plugins = 0u;
+	LilvMatches* matches =
+	    lilv_world_find_matches(world, NULL, rdf_type, plugin_c);
+	for (; !lilv_matches_is_end(matches); lilv_matches_next(matches)) {
+		const LilvNode* const   uri    = lilv_matches_get(matches);
+		const LilvPlugin* const plugin = lilv_plugins_get_by_uri(plugins, uri);
+		assert(plugin);
+
+		LilvNode* const name = lilv_plugin_get_name(plugin);
+		assert(lilv_node_equals(uri, env->plugin1_uri)
+		           ? !strcmp(lilv_node_as_string(name), "First plugin")
+		           : !strcmp(lilv_node_as_string(name), "Second plugin"));
+		lilv_node_free(name);
+		++n_plugins;
+	}
+	lilv_matches_free(matches);
+	assert(n_plugins == 2);
+
+	lilv_node_free(plugin_c);
+	lilv_node_free(rdf_type);
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
@@ -143,6 +143,18 @@ main(void)
 	assert(mins[0] == -1.0f);
 	assert(maxs[0] == 1.0f);
 	assert(defs[0] == 0.5f);
+	assert(mins[1] == -2.0f);
+	assert(maxs[1] == 2.0f);
+	assert(defs[1] == 1.0f);
+	assert(isnan(mins[2]));
+	assert(isnan(maxs[2]));
+	assert(isnan(defs[2]));
+
+	float defs_only[3] = { 0.0f, 0.0f, 0.0f };
+	lilv_plugin_get_port_ranges_float(plug, NULL, NULL, defs_only);
+	assert(defs_only[0] == 0.5f);
+	assert(defs_only[1] == 1.0f);
+	assert(isnan(defs_only[2]));
 
 	LilvNode* audio_class =
 	    lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#AudioPort");
@@ -210,6 +222,19 @@ main(void)
 	assert(lilv_nodes_size(foos) == 1);
 	assert(fabs(lilv_node_as_float(lilv_nodes_get_first(foos)) - 1.6180) <
 	       FLT_EPSILON);
+
+	LilvMatches*    foo_matches = lilv_plugin_get_matches(plug, foo_p);
+	const LilvNode* foo         = lilv_matches_get(foo_matches);
+	assert(lilv_node_equals(foo, lilv_nodes_get_first(foos)));
+	LilvNode* foo_copy = lilv_node_duplicate(foo);
+	lilv_matches_next(foo_matches);
+	assert(lilv_matches_is_end(foo_matches));
+	assert(!lilv_matches_get(foo_matches));
+	assert(lilv_matches_count(foo_matches) == 0);
+	lilv_matches_free(foo_matches);
+	assert(lilv_node_equals(foo_copy, lilv_nodes_get_first(foos)));
+	lilv_node_free(foo_copy);
+
 	lilv_node_free(foo_p);
 	lilv_nodes_free(foos);
 
@@ -253,6 +278,15 @@ main(void)
 	    !strcmp(lilv_node_as_string(author_homepage), "http://drobilla.net"));
 	lilv_node_free(author_homepage);
 
+	const LilvNode* borrowed_name = lilv_plugin_borrow_author_name(plug);
+	assert(!strcmp(lilv_node_as_string(borrowed_name), "David Robillard"));
+	assert(lilv_plugin_borrow_author_name(plug) == borrowed_name);
+	assert(!strcmp(lilv_node_as_string(lilv_plugin_borrow_author_email(plug)),
+	               "mailto:d@drobilla.net"));
+	assert(!strcmp(
+		lilv_node_as_string(lilv_plugin_borrow_author_homepage(plug)),
+		"http://drobilla.net"));
+
 	LilvNode* thing_uri = lilv_new_uri(world, "http://example.org/thing");
 	LilvNode* name_p = lilv_new_uri(world, "http://usefulinc.com/ns/doap#name");
 	LilvNodes* thing_names =
@@ -21,7 +21,9 @@
 #include "lilv/lilv.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 static const char* const plugin_ttl = "\
@@ -74,6 +76,14 @@ static const char* const plugin_ttl = "\
 		lv2:name \"Audio Output\" ;\n\
 	] .\n";
 
+/** Set LANG, and make the world read it again. */
+static void
+set_lang(LilvWorld* world, const char* lang)
+{
+	set_env("LANG", lang);
+	lilv_world_set_option(world, LILV_OPTION_LANG, NULL);
+}
+
 int
 main(void)
 {
@@ -101,6 +111,18 @@ main(void)
 	assert(p3 == NULL);
 	lilv_node_free(nopsym);
 
+	// Every port can be found by its own symbol
+	for (uint32_t i = 0; i < lilv_plugin_get_num_ports(plug); ++i) {
+		const LilvPort* port = lilv_plugin_get_port_by_index(plug, i);
+		const LilvNode* sym  = lilv_port_get_symbol(plug, port);
+		assert(lilv_plugin_get_port_by_symbol(plug, sym) == port);
+	}
+
+	// A symbol must be a string, not a URI with the same text
+	LilvNode* uri_sym = lilv_new_uri(world, "foo");
+	assert(!lilv_plugin_get_port_by_symbol(plug, uri_sym));
+	lilv_node_free(uri_sym);
+
 	// Try getting an invalid property
 	LilvNode*  num     = lilv_new_int(world, 1);
 	LilvNodes* nothing = lilv_port_get_value(plug, p, num);
@@ -132,44 +154,55 @@ main(void)
 	assert(!strcmp(lilv_node_as_string(name), "store"));
 	lilv_node_free(name);
 
-	// Exact language match
+	// Borrowed name, which is remembered
+	const LilvNode* const borrowed = lilv_port_borrow_name(plug, p);
+	assert(!strcmp(lilv_node_as_string(borrowed), "store"));
+	assert(lilv_port_borrow_name(plug, p) == borrowed);
+
+	// Changes to LANG are ignored until the world is told to read it again
 	set_env("LANG", "de_DE");
 	name = lilv_port_get_name(plug, p);
+	assert(!strcmp(lilv_node_as_string(name), "store"));
+	lilv_node_free(name);
+
+	// Exact language match
+	set_lang(world, "de_DE");
+	name = lilv_port_get_name(plug, p);
 	assert(!strcmp(lilv_node_as_string(name), "Laden"));
 	lilv_node_free(name);
 
 	// Exact language match (with charset suffix)
-	set_env("LANG", "de_AT.utf8");
+	set_lang(world, "de_AT.utf8");
 	name = lilv_port_get_name(plug, p);
 	assert(!strcmp(lilv_node_as_string(name), "Geschaeft"));
 	lilv_node_free(name);
 
 	// Partial language match (choose value translated for different country)
-	set_env("LANG", "de_CH");
+	set_lang(world, "de_CH");
 	name = lilv_port_get_name(plug, p);
 	assert((!strcmp(lilv_node_as_string(name), "Laden")) ||
 	       (!strcmp(lilv_node_as_string(name), "Geschaeft")));
 	lilv_node_free(name);
 
 	// Partial language match (choose country-less language tagged value)
-	set_env("LANG", "es_MX");
+	set_lang(world, "es_MX");
 	name = lilv_port_get_name(plug, p);
 	assert(!strcmp(lilv_node_as_string(name), "tienda"));
 	lilv_node_free(name);
 
 	// No language match (choose untranslated value)
-	set_env("LANG", "cn");
+	set_lang(world, "cn");
 	name = lilv_port_get_name(plug, p);
 	assert(!strcmp(lilv_node_as_string(name), "store"));
 	lilv_node_free(name);
 
 	// Invalid language
-	set_env("LANG", "1!");
+	set_lang(world, "1!");
 	name = lilv_port_get_name(plug, p);
 	assert(!strcmp(lilv_node_as_string(name), "store"));
 	lilv_node_free(name);
 
-	set_env("LANG", "en_CA.utf-8");
+	set_lang(world, "en_CA.utf-8");
 
 	// Language tagged value with no untranslated values
 	LilvNode*  rdfs_comment = lilv_new_uri(world, LILV_NS_RDFS "comment");
@@ -181,14 +214,14 @@ main(void)
 	lilv_node_free(comment);
 	lilv_nodes_free(comments);
 
-	set_env("LANG", "fr");
+	set_lang(world, "fr");
 
 	comments = lilv_port_get_value(plug, p, rdfs_comment);
 	assert(!strcmp(lilv_node_as_string(lilv_nodes_get_first(comments)),
 	               "commentaires"));
 	lilv_nodes_free(comments);
 
-	set_env("LANG", "cn");
+	set_lang(world, "cn");
 
 	comments = lilv_port_get_value(plug, p, rdfs_comment);
 	assert(!comments);
@@ -196,6 +229,23 @@ main(void)
 
 	lilv_node_free(rdfs_comment);
 
+	// Language set explicitly, which overrides LANG
+	LilvNode* lang = lilv_new_string(world, "de_AT.UTF-8");
+	lilv_world_set_option(world, LILV_OPTION_LANG, lang);
+	set_env("LANG", "de_DE");
+	name = lilv_port_get_name(plug, p);
+	assert(!strcmp(lilv_node_as_string(name), "Geschaeft"));
+	lilv_node_free(name);
+	lilv_node_free(lang);
+
+	// No language set explicitly (choose untranslated value)
+	lang = lilv_new_string(world, "");
+	lilv_world_set_option(world, LILV_OPTION_LANG, lang);
+	name = lilv_port_get_name(plug, p);
+	assert(!strcmp(lilv_node_as_string(name), "store"));
+	lilv_node_free(name);
+	lilv_node_free(lang);
+
 	set_env("LANG", "C"); // Reset locale
 
 	LilvScalePoints* points = lilv_port_get_scale_points(plug, p);
@@ -239,6 +289,18 @@ main(void)
 	assert(lilv_node_as_float(min) == -1.0);
 	assert(lilv_node_as_float(max) == 1.0);
 
+	// Decoded literals are remembered, and give equal nodes the second time
+	LilvNode* min2 = NULL;
+	LilvNode* max2 = NULL;
+	LilvNode* def2 = NULL;
+	lilv_port_get_range(plug, p, &def2, &min2, &max2);
+	assert(lilv_node_is_float(def2) && lilv_node_equals(def2, def));
+	assert(lilv_node_is_float(min2) && lilv_node_equals(min2, min));
+	assert(lilv_node_is_float(max2) && lilv_node_equals(max2, max));
+	lilv_node_free(min2);
+	lilv_node_free(max2);
+	lilv_node_free(def2);
+
 	LilvNode* integer_prop =
 	    lilv_new_uri(world, "http://lv2plug.in/ns/lv2core#integer");
 	LilvNode* toggled_prop =
@@ -272,6 +334,14 @@ main(void)
 	names = lilv_port_get_value(plug, p, name_p);
 	assert(lilv_nodes_size(names) == 4);
 	lilv_nodes_free(names);
+
+	// Streamed values are never filtered by language
+	LilvMatches* name_matches = lilv_port_get_matches(plug, p, name_p);
+	assert(lilv_node_is_string(lilv_matches_get(name_matches)));
+	lilv_matches_next(name_matches);
+	assert(lilv_matches_count(name_matches) == 3);
+	assert(lilv_matches_is_end(name_matches));
+	lilv_matches_free(name_matches);
 	lilv_world_set_option(world, LILV_OPTION_FILTER_LANG, true_val);
 
 	lilv_node_free(false_val);
@@ -296,6 +366,33 @@ main(void)
 	assert(lilv_port_is_a(plug, ap_out, audio_class));
 	assert(!lilv_port_is_a(plug, ap_out, control_class));
 
+	assert(!lilv_plugin_has_latency(plug));
+	assert(lilv_plugin_get_latency_port_index(plug) == UINT32_MAX);
+
+	const LilvPortDescriptor* table = lilv_plugin_get_port_table(plug);
+	assert(table);
+	assert(table == lilv_plugin_get_port_table(plug));
+	assert(table[0].index == 0);
+	assert(!strcmp(table[0].symbol, "foo"));
+	assert(table[0].direction == LILV_PORT_DIRECTION_INPUT);
+	assert(table[0].types == LILV_PORT_TYPE_CONTROL);
+	assert(table[0].properties == LILV_PORT_PROPERTY_INTEGER);
+	assert(table[0].min == -1.0f);
+	assert(table[0].max == 1.0f);
+	assert(table[0].def == 0.5f);
+	assert(table[1].index == 1);
+	assert(table[1].direction == LILV_PORT_DIRECTION_INPUT);
+	assert(table[1].types == 0);
+	assert(table[2].direction == LILV_PORT_DIRECTION_INPUT);
+	assert(table[2].types == LILV_PORT_TYPE_AUDIO);
+	assert(table[2].properties == 0);
+	assert(isnan(table[2].min));
+	assert(isnan(table[2].max));
+	assert(isnan(table[2].def));
+	assert(!strcmp(table[3].symbol, "audio_out"));
+	assert(table[3].direction == LILV_PORT_DIRECTION_OUTPUT);
+	assert(table[3].types == LILV_PORT_TYPE_AUDIO);
+
 	assert(lilv_plugin_get_num_ports_of_class(
 	           plug, control_class, in_class, NULL) == 1);
 	assert(
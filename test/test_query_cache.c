@@ -0,0 +1,132 @@
+/*
+  Copyright 2007-2020 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define RDFS_LABEL "http://www.w3.org/2000/01/rdf-schema#label"
+
+#define MANIFEST_TTL(name) \
+	":plug a lv2:Plugin ; lv2:binary <foo" SHLIB_EXT "> ; " \
+	"rdfs:label \"" name "\" ; rdfs:seeAlso <plugin.ttl> .\n"
+
+static void
+check_label(LilvWorld*      world,
+            const LilvNode* plug_uri,
+            const char*     expected)
+{
+	LilvNode* rdfs_label = lilv_new_uri(world, RDFS_LABEL);
+	LilvNode* name       = lilv_world_get(world, plug_uri, rdfs_label, NULL);
+	assert(name);
+	assert(!strcmp(lilv_node_as_string(name), expected));
+
+	LilvNodes* names = lilv_world_find_nodes(world, plug_uri, rdfs_label, NULL);
+	assert(lilv_nodes_size(names) == 1);
+	assert(lilv_nodes_contains(names, name));
+	assert(lilv_world_ask(world, plug_uri, rdfs_label, name));
+
+	lilv_nodes_free(names);
+	lilv_node_free(name);
+	lilv_node_free(rdfs_label);
+}
+
+static LilvWorldStats
+get_stats(LilvWorld* world)
+{
+	LilvWorldStats stats;
+	lilv_world_get_stats(world, &stats);
+	return stats;
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	create_bundle(env, MANIFEST_TTL("First name"), ":plug a lv2:Plugin .");
+
+	LilvNode* size = lilv_new_int(world, 16);
+	lilv_world_set_option(world, LILV_OPTION_QUERY_CACHE_SIZE, size);
+	lilv_node_free(size);
+
+	LilvNode* bundle_uri = lilv_new_uri(world, env->test_bundle_uri);
+	lilv_world_load_bundle(world, bundle_uri);
+	lilv_world_reset_stats(world);
+
+	// The first get and ask search the model, finding uses the got result
+	check_label(world, env->plugin1_uri, "First name");
+	LilvWorldStats stats = get_stats(world);
+	assert(stats.n_query_cache_hits == 1);
+	assert(stats.n_query_cache_misses == 2);
+
+	// Repeating them uses the cache
+	check_label(world, env->plugin1_uri, "First name");
+	stats = get_stats(world);
+	assert(stats.n_query_cache_hits == 4);
+	assert(stats.n_query_cache_misses == 2);
+
+	// Building plugin classes adds no statements, so keeps the results
+	assert(lilv_world_get_plugin_classes(world));
+	check_label(world, env->plugin1_uri, "First name");
+	stats = get_stats(world);
+	assert(stats.n_query_cache_hits == 7);
+	assert(stats.n_query_cache_misses == 2);
+
+	// Loading plugin data when first needed forgets them
+	const LilvPlugin* plug = lilv_plugins_get_by_uri(
+	    lilv_world_get_all_plugins(world), env->plugin1_uri);
+	assert(plug);
+	assert(lilv_plugin_get_num_ports(plug) == 0);
+	check_label(world, env->plugin1_uri, "First name");
+	stats = get_stats(world);
+	assert(stats.n_query_cache_hits == 8);
+	assert(stats.n_query_cache_misses == 4);
+
+	// Reloading the bundle forgets the cached results
+	lilv_world_unload_bundle(world, bundle_uri);
+	delete_bundle(env);
+	create_bundle(env, MANIFEST_TTL("Second name"), ":plug a lv2:Plugin .");
+	lilv_world_load_bundle(world, bundle_uri);
+
+	check_label(world, env->plugin1_uri, "Second name");
+	stats = get_stats(world);
+	assert(stats.n_query_cache_hits == 9);
+	assert(stats.n_query_cache_misses == 6);
+
+	// Disabling the cache searches the model every time
+	size = lilv_new_int(world, 0);
+	lilv_world_set_option(world, LILV_OPTION_QUERY_CACHE_SIZE, size);
+	lilv_node_free(size);
+
+	check_label(world, env->plugin1_uri, "Second name");
+	stats = get_stats(world);
+	assert(stats.n_query_cache_hits == 9);
+	assert(stats.n_query_cache_misses == 6);
+
+	lilv_node_free(bundle_uri);
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
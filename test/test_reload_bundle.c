@@ -50,6 +50,8 @@ main(void)
 	// Check that plugin name is correct
 	LilvNode* name = lilv_plugin_get_name(plug);
 	assert(!strcmp(lilv_node_as_string(name), "First name"));
+	assert(!strcmp(lilv_node_as_string(lilv_plugin_borrow_name(plug)),
+	               "First name"));
 	lilv_node_free(name);
 
 	// Unload bundle from world and delete it
@@ -65,6 +67,7 @@ main(void)
 
 	// Check that plugin is no longer in the world's plugin list
 	assert(lilv_plugins_size(plugins) == 0);
+	assert(!lilv_plugins_get_by_uri(plugins, env->plugin1_uri));
 
 	// Load new bundle
 	lilv_world_load_bundle(world, bundle_uri);
@@ -79,6 +82,8 @@ main(void)
 	LilvNode* name2 = lilv_plugin_get_name(plug2);
 	assert(name2);
 	assert(!strcmp(lilv_node_as_string(name2), "Second name"));
+	assert(!strcmp(lilv_node_as_string(lilv_plugin_borrow_name(plug2)),
+	               "Second name"));
 	lilv_node_free(name2);
 
 	// Load new bundle again (noop)
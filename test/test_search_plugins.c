@@ -0,0 +1,134 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+
+static const char* const manifest_ttl = "\
+:plug a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n\
+:foobar a lv2:Plugin ;\n\
+	lv2:binary <foo" SHLIB_EXT "> ;\n\
+	rdfs:seeAlso <plugin.ttl> .\n";
+
+static const char* const plugin_ttl = "\
+:suite\n\
+	doap:name \"Example Suite\" .\n\
+:plug a lv2:Plugin ;\n\
+	a lv2:CompressorPlugin ;\n\
+	doap:name \"Stereo Compressor\" ;\n\
+	rdfs:label \"Squash\" ;\n\
+	lv2:project :suite ;\n\
+	doap:maintainer [\n\
+		foaf:name \"Jane Smith\"\n\
+	] ;\n\
+	lv2:port [\n\
+		a lv2:ControlPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"foo\" ;\n\
+		lv2:name \"bar\" ;\n\
+	] .\n\
+:foobar a lv2:Plugin ;\n\
+	a lv2:DynamicsPlugin ;\n\
+	doap:name \"Mono Gate\" ;\n\
+	doap:maintainer [\n\
+		foaf:name \"Stereo Labs\"\n\
+	] ;\n\
+	lv2:port [\n\
+		a lv2:AudioPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"in\" ;\n\
+		lv2:name \"In\" ;\n\
+	] .\n";
+
+/** Return the single plugin that matches `text`, or NULL. */
+static const LilvPlugin*
+search_one(LilvWorld* world, const char* text)
+{
+	const LilvPlugin* result = NULL;
+	if (lilv_world_search_plugins(world, text, &result, 1) != 1) {
+		return NULL;
+	}
+
+	return result;
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	if (start_bundle(env, manifest_ttl, plugin_ttl)) {
+		return 1;
+	}
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug = lilv_plugins_get_by_uri(plugins, env->plugin1_uri);
+	const LilvPlugin*  gate = lilv_plugins_get_by_uri(plugins, env->plugin2_uri);
+
+	// Each field, by whole word, prefix, and substring
+	assert(search_one(world, "compressor") == plug);
+	assert(search_one(world, "comp") == plug);
+	assert(search_one(world, "pressor") == plug);
+	assert(search_one(world, "squash") == plug);
+	assert(search_one(world, "suite") == plug);
+	assert(search_one(world, "jane") == plug);
+	assert(search_one(world, "gat") == gate);
+
+	// Case and punctuation are ignored, and every word must match
+	assert(search_one(world, "MONO, gate!") == gate);
+	assert(search_one(world, "stereo comp") == plug);
+	assert(!lilv_world_search_plugins(world, "stereo gate", NULL, 0));
+
+	// Short words only match prefixes
+	assert(!lilv_world_search_plugins(world, "pr", NULL, 0));
+
+	// Empty searches match nothing
+	assert(!lilv_world_search_plugins(world, "", NULL, 0));
+	assert(!lilv_world_search_plugins(world, " - ", NULL, 0));
+
+	// Names are ranked above authors
+	const LilvPlugin* results[2] = {NULL, NULL};
+	assert(lilv_world_search_plugins(world, "stereo", results, 2) == 2);
+	assert(results[0] == plug);
+	assert(results[1] == gate);
+
+	// Results are limited to the given size, but all matches are counted
+	results[0] = results[1] = NULL;
+	assert(lilv_world_search_plugins(world, "stereo", results, 1) == 2);
+	assert(results[0] == plug);
+	assert(!results[1]);
+
+	// Unloading the bundle removes its plugins from the index
+	LilvNode* bundle_uri = lilv_new_uri(world, env->test_bundle_uri);
+	lilv_world_unload_bundle(world, bundle_uri);
+	assert(!lilv_world_search_plugins(world, "stereo", NULL, 0));
+	lilv_node_free(bundle_uri);
+
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
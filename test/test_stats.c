@@ -0,0 +1,112 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	a lv2:CompressorPlugin ;\n\
+	doap:name \"Test plugin\" ;\n\
+	lv2:port [\n\
+		a lv2:ControlPort ;\n\
+		a lv2:InputPort ;\n\
+		lv2:index 0 ;\n\
+		lv2:symbol \"foo\" ;\n\
+		lv2:name \"bar\" ;\n\
+	] .\n";
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	LilvWorldStats stats;
+	lilv_world_get_stats(world, &stats);
+	assert(stats.n_bundles == 0);
+	assert(stats.n_files == 0);
+	assert(stats.n_plugin_loads == 0);
+
+	if (start_bundle(env, SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+		return 1;
+	}
+
+	// Scanning reads manifests, but does not load plugin data
+	lilv_world_get_stats(world, &stats);
+	assert(stats.n_bundles >= 1);
+	assert(stats.n_files >= 1);
+	assert(stats.n_statements > 0);
+	assert(stats.n_plugin_loads == 0);
+	assert(stats.model_statements > 0);
+	assert(stats.model_nodes > 0);
+	assert(stats.model_size > 0);
+
+	const uint64_t n_files      = stats.n_files;
+	const uint64_t n_statements = stats.n_statements;
+
+	// Querying the plugin loads its data
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	const LilvPlugin*  plug = lilv_plugins_get_by_uri(plugins, env->plugin1_uri);
+	LilvNode*          name = lilv_plugin_get_name(plug);
+	assert(!strcmp(lilv_node_as_string(name), "Test plugin"));
+	lilv_node_free(name);
+
+	lilv_world_get_stats(world, &stats);
+	assert(stats.n_plugin_loads == 1);
+	assert(stats.n_files > n_files);
+	assert(stats.n_statements > n_statements);
+	assert(stats.n_searches > 0);
+
+	// The bundle is charged for both of its files
+	LilvNode*    bundle_uri = lilv_new_uri(world, env->test_bundle_uri);
+	const double parse_time =
+		lilv_world_get_bundle_parse_time(world, bundle_uri);
+	assert(parse_time >= 0.0);
+	assert(parse_time <= stats.parse_time);
+
+	// Loading is counted only once
+	assert(lilv_plugin_get_num_ports(plug) == 1);
+	lilv_world_get_stats(world, &stats);
+	assert(stats.n_plugin_loads == 1);
+
+	// Resetting clears counters, but not the current model size
+	lilv_world_reset_stats(world);
+	lilv_world_get_stats(world, &stats);
+	assert(stats.n_bundles == 0);
+	assert(stats.n_files == 0);
+	assert(stats.n_statements == 0);
+	assert(stats.parse_time == 0.0);
+	assert(stats.n_searches == 0);
+	assert(stats.n_plugin_loads == 0);
+	assert(stats.n_lib_opens == 0);
+	assert(stats.model_statements > 0);
+	assert(lilv_world_get_bundle_parse_time(world, bundle_uri) == 0.0);
+
+	lilv_node_free(bundle_uri);
+
+	delete_bundle(env);
+	lilv_test_env_free(env);
+
+	return 0;
+}
@@ -0,0 +1,127 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_config.h"
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+#include "lv2/core/lv2.h"
+#include "lv2/urid/urid.h"
+
+#ifdef HAVE_PTHREAD
+#    include <pthread.h>
+#endif
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N_URIS    5000
+#define N_THREADS 4
+
+typedef struct {
+	LV2_URID_Map* map;
+	LV2_URID      urids[N_URIS];
+} MapThread;
+
+static void
+make_uri(char* buf, size_t size, unsigned i)
+{
+	snprintf(buf, size, "http://example.org/uri%u", i);
+}
+
+static void*
+map_run(void* data)
+{
+	MapThread* const thread = (MapThread*)data;
+	char             uri[64];
+
+	for (unsigned i = 0; i < N_URIS; ++i) {
+		make_uri(uri, sizeof(uri), i);
+		thread->urids[i] = thread->map->map(thread->map->handle, uri);
+	}
+
+	return NULL;
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	LV2_URID_Map* const   map   = lilv_world_get_urid_map(world);
+	LV2_URID_Unmap* const unmap = lilv_world_get_urid_unmap(world);
+
+	// Features refer to the same map and unmap
+	const LV2_Feature* map_feature   = lilv_world_get_urid_map_feature(world);
+	const LV2_Feature* unmap_feature = lilv_world_get_urid_unmap_feature(world);
+	assert(!strcmp(map_feature->URI, LV2_URID__map));
+	assert(!strcmp(unmap_feature->URI, LV2_URID__unmap));
+	assert(map_feature->data == map);
+	assert(unmap_feature->data == unmap);
+
+	// Mapping is stable and unmapping round trips
+	const LV2_URID foo = map->map(map->handle, "http://example.org/foo");
+	const LV2_URID bar = map->map(map->handle, "http://example.org/bar");
+	assert(foo && bar && foo != bar);
+	assert(map->map(map->handle, "http://example.org/foo") == foo);
+	assert(!strcmp(unmap->unmap(unmap->handle, foo), "http://example.org/foo"));
+	assert(!strcmp(unmap->unmap(unmap->handle, bar), "http://example.org/bar"));
+
+	// Unknown URIDs are not unmapped
+	assert(!unmap->unmap(unmap->handle, 0));
+	assert(!unmap->unmap(unmap->handle, bar + 1));
+
+	// Map many URIs from several threads at once
+	static MapThread threads[N_THREADS];
+#ifdef HAVE_PTHREAD
+	pthread_t handles[N_THREADS];
+	for (unsigned t = 0; t < N_THREADS; ++t) {
+		threads[t].map = map;
+		assert(!pthread_create(&handles[t], NULL, map_run, &threads[t]));
+	}
+
+	for (unsigned t = 0; t < N_THREADS; ++t) {
+		pthread_join(handles[t], NULL);
+	}
+#else
+	for (unsigned t = 0; t < N_THREADS; ++t) {
+		threads[t].map = map;
+		map_run(&threads[t]);
+	}
+#endif
+
+	// Every thread got the same URIDs, which unmap to the original URIs
+	char uri[64];
+	for (unsigned i = 0; i < N_URIS; ++i) {
+		make_uri(uri, sizeof(uri), i);
+		for (unsigned t = 1; t < N_THREADS; ++t) {
+			assert(threads[t].urids[i] == threads[0].urids[i]);
+		}
+
+		assert(!strcmp(unmap->unmap(unmap->handle, threads[0].urids[i]), uri));
+	}
+
+	assert(map->map(map->handle, "http://example.org/foo") == foo);
+
+	lilv_test_env_free(env);
+
+	return 0;
+}
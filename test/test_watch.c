@@ -0,0 +1,105 @@
+/*
+  Copyright 2021 David Robillard <http://drobilla.net>
+
+  Permission to use, copy, modify, and/or distribute this software for any
+  purpose with or without fee is hereby granted, provided that the above
+  copyright notice and this permission notice appear in all copies.
+
+  THIS SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+#undef NDEBUG
+
+#include "lilv_test_utils.h"
+
+#include "lilv/lilv.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* const plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	doap:name \"First name\" .\n";
+
+static const char* const changed_plugin_ttl = "\
+:plug a lv2:Plugin ;\n\
+	doap:name \"Second name\" .\n";
+
+static void
+write_plugin_file(const LilvTestEnv* env, const char* plugin)
+{
+	FILE* const file = fopen(env->test_content_path, "w");
+	assert(file);
+	fwrite(PLUGIN_PREFIXES, 1, strlen(PLUGIN_PREFIXES), file);
+	fwrite(plugin, 1, strlen(plugin), file);
+	fclose(file);
+}
+
+static void
+check_name(const LilvPlugin* plug, const char* expected)
+{
+	LilvNode* name = lilv_plugin_get_name(plug);
+	assert(name);
+	assert(!strcmp(lilv_node_as_string(name), expected));
+	lilv_node_free(name);
+}
+
+int
+main(void)
+{
+	LilvTestEnv* const env   = lilv_test_env_new();
+	LilvWorld* const   world = env->world;
+
+	// Make sure the LV2_PATH directory exists, but the bundle does not
+	if (create_bundle(env, SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+		return 1;
+	}
+	delete_bundle(env);
+
+	assert(lilv_world_poll_changes(world) == -1);
+
+	lilv_world_load_all(world);
+	if (lilv_world_watch(world)) {
+		// Watching is not supported on this platform
+		lilv_test_env_free(env);
+		return 0;
+	}
+
+	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
+	assert(!lilv_plugins_get_by_uri(plugins, env->plugin1_uri));
+	assert(lilv_world_poll_changes(world) == 0);
+
+	// Install a new bundle, which should be loaded once
+	if (create_bundle(env, SIMPLE_MANIFEST_TTL, plugin_ttl)) {
+		return 1;
+	}
+
+	assert(lilv_world_poll_changes(world) == 1);
+	const LilvPlugin* plug = lilv_plugins_get_by_uri(plugins, env->plugin1_uri);
+	assert(plug);
+	check_name(plug, "First name");
+	assert(lilv_world_poll_changes(world) == 0);
+
+	// Modify the plugin data, which should reload the same plugin
+	write_plugin_file(env, changed_plugin_ttl);
+	assert(lilv_world_poll_changes(world) == 1);
+	assert(lilv_plugins_get_by_uri(plugins, env->plugin1_uri) == plug);
+	check_name(plug, "Second name");
+
+	// Remove the bundle, which should unload the plugin
+	delete_bundle(env);
+	assert(lilv_world_poll_changes(world) == 1);
+	assert(!lilv_plugins_get_by_uri(plugins, env->plugin1_uri));
+	assert(lilv_world_poll_changes(world) == 0);
+
+	lilv_test_env_free(env);
+
+	return 0;
+}
@@ -332,8 +332,14 @@ main(int argc, char** argv)
 	const uint32_t n_ports = lilv_plugin_get_num_ports(plugin);
 	float          in_buf[self.n_audio_in > 0 ? self.n_audio_in : 1];
 	float          out_buf[self.n_audio_out > 0 ? self.n_audio_out : 1];
+	const LV2_Feature* features[] = {
+		lilv_world_get_urid_map_feature(self.world),
+		lilv_world_get_urid_unmap_feature(self.world),
+		NULL
+	};
+
 	self.instance = lilv_plugin_instantiate(
-		self.plugin, in_fmt.samplerate, NULL);
+		self.plugin, in_fmt.samplerate, features);
 	for (uint32_t p = 0, i = 0, o = 0; p < n_ports; ++p) {
 		if (self.ports[p].type == TYPE_CONTROL) {
 			lilv_instance_connect_port(self.instance, p, &self.ports[p].value);
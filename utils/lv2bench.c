@@ -23,7 +23,6 @@
 
 #include "bench.h"
 #include "lilv_config.h"
-#include "uri_table.h"
 
 #include <math.h>
 #include <stdbool.h>
@@ -69,16 +68,17 @@ print_usage(void)
 }
 
 static double
-bench(const LilvPlugin* p, uint32_t sample_count, uint32_t block_size)
+bench(LilvWorld*        world,
+      const LilvPlugin* p,
+      uint32_t          sample_count,
+      uint32_t          block_size)
 {
-	URITable uri_table;
-	uri_table_init(&uri_table);
-
-	LV2_URID_Map       map           = { &uri_table, uri_table_map };
-	LV2_Feature        map_feature   = { LV2_URID_MAP_URI, &map };
-	LV2_URID_Unmap     unmap         = { &uri_table, uri_table_unmap };
-	LV2_Feature        unmap_feature = { LV2_URID_UNMAP_URI, &unmap };
-	const LV2_Feature* features[]    = { &map_feature, &unmap_feature, NULL };
+	LV2_URID_Map* const map        = lilv_world_get_urid_map(world);
+	const LV2_Feature*  features[] = {
+		lilv_world_get_urid_map_feature(world),
+		lilv_world_get_urid_unmap_feature(world),
+		NULL
+	};
 
 	float* const buf = (float*)calloc(block_size * 2, sizeof(float));
 	float* const in  = buf;
@@ -92,7 +92,7 @@ bench(const LilvPlugin* p, uint32_t sample_count, uint32_t block_size)
 
 	LV2_Atom_Sequence seq_in = {
 		{ sizeof(LV2_Atom_Sequence_Body),
-		  uri_table_map(&uri_table, LV2_ATOM__Sequence) },
+		  map->map(map->handle, LV2_ATOM__Sequence) },
 		{ 0, 0 } };
 
 	LV2_Atom_Sequence* seq_out = (LV2_Atom_Sequence*)malloc(
@@ -107,7 +107,6 @@ bench(const LilvPlugin* p, uint32_t sample_count, uint32_t block_size)
 			        uri, lilv_node_as_uri(feature));
 			free(seq_out);
 			free(buf);
-			uri_table_destroy(&uri_table);
 			return 0.0;
 		}
 	}
@@ -118,7 +117,6 @@ bench(const LilvPlugin* p, uint32_t sample_count, uint32_t block_size)
 		        lilv_node_as_uri(lilv_plugin_get_uri(p)));
 		free(seq_out);
 		free(buf);
-		uri_table_destroy(&uri_table);
 		return 0.0;
 	}
 
@@ -154,7 +152,6 @@ bench(const LilvPlugin* p, uint32_t sample_count, uint32_t block_size)
 				free(seq_out);
 				free(buf);
 				free(controls);
-				uri_table_destroy(&uri_table);
 				return 0.0;
 			}
 		} else if (lilv_port_is_a(p, port, atom_AtomPort)) {
@@ -170,7 +167,6 @@ bench(const LilvPlugin* p, uint32_t sample_count, uint32_t block_size)
 			free(seq_out);
 			free(buf);
 			free(controls);
-			uri_table_destroy(&uri_table);
 			return 0.0;
 		}
 	}
@@ -180,9 +176,9 @@ bench(const LilvPlugin* p, uint32_t sample_count, uint32_t block_size)
 	struct timespec ts = bench_start();
 	for (uint32_t i = 0; i < (sample_count / block_size); ++i) {
 		seq_in.atom.size   = sizeof(LV2_Atom_Sequence_Body);
-		seq_in.atom.type   = uri_table_map(&uri_table, LV2_ATOM__Sequence);
+		seq_in.atom.type   = map->map(map->handle, LV2_ATOM__Sequence);
 		seq_out->atom.size = atom_capacity;
-		seq_out->atom.type = uri_table_map(&uri_table, LV2_ATOM__Chunk);
+		seq_out->atom.type = map->map(map->handle, LV2_ATOM__Chunk);
 
 		lilv_instance_run(instance, block_size);
 	}
@@ -195,8 +191,6 @@ bench(const LilvPlugin* p, uint32_t sample_count, uint32_t block_size)
 	free(mins);
 	free(seq_out);
 
-	uri_table_destroy(&uri_table);
-
 	if (full_output) {
 		printf("%u %u ", block_size, sample_count);
 	}
@@ -255,11 +249,17 @@ main(int argc, char** argv)
 	const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
 	if (plugin_uri_str) {
 		LilvNode* uri = lilv_new_uri(world, plugin_uri_str);
-		bench(lilv_plugins_get_by_uri(plugins, uri), sample_count, block_size);
+		bench(world,
+		      lilv_plugins_get_by_uri(plugins, uri),
+		      sample_count,
+		      block_size);
 		lilv_node_free(uri);
 	} else {
 		LILV_FOREACH(plugins, i, plugins) {
-			bench(lilv_plugins_get(plugins, i), sample_count, block_size);
+			bench(world,
+			      lilv_plugins_get(plugins, i),
+			      sample_count,
+			      block_size);
 		}
 	}
 